@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../sparse_vector.h"
+#include "perf_counters.h"
+#include "latency_histogram.h"
+
+namespace {
+
+	using clock_type = std::chrono::steady_clock;
+	using value_vector = Byte::sparse_vector<uint64_t>;
+
+	struct benchmark_options {
+		size_t size{ 1 << 20 };
+		bool perf{ false };
+		bool latency{ false };
+		std::string output;
+	};
+
+	struct benchmark_result {
+		std::string name;
+		size_t operations;
+		double nanoseconds;
+		Byte::perf_counters::sample counters;
+	};
+
+	struct latency_result {
+		std::string name;
+		Byte::latency_histogram histogram;
+	};
+
+	volatile uint64_t sink_value{ 0 };
+
+	template<typename Fn>
+	benchmark_result measure(const std::string& name, size_t operations, Byte::perf_counters& counters, Fn&& fn) {
+		counters.start();
+		clock_type::time_point begin{ clock_type::now() };
+
+		fn();
+
+		clock_type::time_point end{ clock_type::now() };
+		Byte::perf_counters::sample sample{ counters.stop() };
+
+		return benchmark_result{ name, operations, std::chrono::duration<double, std::nano>(end - begin).count(), sample };
+	}
+
+	value_vector filled(size_t size, double density, std::mt19937_64& rng) {
+		value_vector out;
+
+		for (size_t index{ 0 }; index < size; ++index) {
+			out.push(index);
+		}
+
+		std::bernoulli_distribution erase{ 1.0 - density };
+		for (size_t index{ 0 }; index < size; ++index) {
+			if (erase(rng)) {
+				out.erase(index);
+			}
+		}
+
+		return out;
+	}
+
+	std::vector<size_t> shuffled(size_t size, std::mt19937_64& rng) {
+		std::vector<size_t> out(size);
+		for (size_t index{ 0 }; index < size; ++index) {
+			out[index] = index;
+		}
+		std::shuffle(out.begin(), out.end(), rng);
+		return out;
+	}
+
+	std::vector<benchmark_result> run(const benchmark_options& options) {
+		std::vector<benchmark_result> results;
+		std::mt19937_64 rng{ 42 };
+		Byte::perf_counters counters{ options.perf };
+
+		size_t size{ options.size };
+		value_vector values;
+
+		results.push_back(measure("push", size, counters, [&] {
+			for (size_t index{ 0 }; index < size; ++index) {
+				values.push(index);
+			}
+		}));
+
+		std::vector<size_t> order{ shuffled(size, rng) };
+
+		results.push_back(measure("at", size, counters, [&] {
+			uint64_t sum{ 0 };
+			for (size_t index : order) {
+				sum += values.at(index);
+			}
+			sink_value = sum;
+		}));
+
+		for (double density : { 0.1, 0.5, 1.0 }) {
+			value_vector sparse{ filled(size, density, rng) };
+			std::string name{ "iterate_" + std::to_string(static_cast<int>(density * 100)) };
+
+			results.push_back(measure(name, sparse.size(), counters, [&] {
+				uint64_t sum{ 0 };
+				for (uint64_t value : sparse) {
+					sum += value;
+				}
+				sink_value = sum;
+			}));
+		}
+
+		results.push_back(measure("erase", size, counters, [&] {
+			for (size_t index : order) {
+				values.erase(index);
+			}
+		}));
+
+		return results;
+	}
+
+	template<typename Fn>
+	void timed(Byte::latency_histogram& histogram, Fn&& fn) {
+		clock_type::time_point begin{ clock_type::now() };
+		fn();
+		clock_type::time_point end{ clock_type::now() };
+
+		histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+	}
+
+	size_t take(std::vector<size_t>& indices, std::mt19937_64& rng) {
+		size_t position{ std::uniform_int_distribution<size_t>{ 0, indices.size() - 1 }(rng) };
+		size_t index{ indices[position] };
+
+		indices[position] = indices.back();
+		indices.pop_back();
+
+		return index;
+	}
+
+	std::vector<latency_result> run_latency(const benchmark_options& options) {
+		std::vector<latency_result> results;
+		std::mt19937_64 rng{ 42 };
+		size_t size{ options.size };
+
+		{
+			latency_result push{ "latency_growth_push", Byte::latency_histogram{} };
+			value_vector values;
+
+			for (size_t index{ 0 }; index < size; ++index) {
+				timed(push.histogram, [&] {
+					values.push(index);
+				});
+			}
+
+			results.push_back(std::move(push));
+		}
+
+		{
+			latency_result push{ "latency_churn_push", Byte::latency_histogram{} };
+			latency_result erase{ "latency_churn_erase", Byte::latency_histogram{} };
+			value_vector values;
+			std::vector<size_t> live;
+
+			for (size_t index{ 0 }; index < size; ++index) {
+				live.push_back(values.push(index));
+			}
+
+			std::bernoulli_distribution grow{ 0.5 };
+			for (size_t operation{ 0 }; operation < size; ++operation) {
+				if (grow(rng) || live.empty()) {
+					size_t index{ 0 };
+					timed(push.histogram, [&] {
+						index = values.push(operation);
+					});
+					live.push_back(index);
+				}
+				else {
+					size_t index{ take(live, rng) };
+					timed(erase.histogram, [&] {
+						values.erase(index);
+					});
+				}
+			}
+
+			results.push_back(std::move(push));
+			results.push_back(std::move(erase));
+		}
+
+		{
+			latency_result insert{ "latency_refill_insert", Byte::latency_histogram{} };
+			latency_result erase{ "latency_refill_erase", Byte::latency_histogram{} };
+			value_vector values;
+			std::vector<size_t> live;
+			std::vector<size_t> freed;
+
+			for (size_t index{ 0 }; index < size; ++index) {
+				live.push_back(values.push(index));
+			}
+
+			std::bernoulli_distribution refill{ 0.5 };
+			for (size_t operation{ 0 }; operation < size; ++operation) {
+				if ((refill(rng) && !freed.empty()) || live.empty()) {
+					size_t index{ take(freed, rng) };
+					timed(insert.histogram, [&] {
+						values.insert(index, operation);
+					});
+					live.push_back(index);
+				}
+				else {
+					size_t index{ take(live, rng) };
+					timed(erase.histogram, [&] {
+						values.erase(index);
+					});
+					freed.push_back(index);
+				}
+			}
+
+			results.push_back(std::move(insert));
+			results.push_back(std::move(erase));
+		}
+
+		return results;
+	}
+
+	void write_latency_json(std::ostream& out, const std::vector<latency_result>& results) {
+		out << "[\n";
+
+		for (size_t result_index{ 0 }; result_index < results.size(); ++result_index) {
+			const latency_result& result{ results[result_index] };
+			const Byte::latency_histogram& histogram{ result.histogram };
+
+			out << "  {\"name\": \"" << result.name << "\", \"operations\": " << histogram.count()
+				<< ", \"p50_ns\": " << histogram.percentile(0.5)
+				<< ", \"p99_ns\": " << histogram.percentile(0.99)
+				<< ", \"p99_9_ns\": " << histogram.percentile(0.999)
+				<< ", \"p99_99_ns\": " << histogram.percentile(0.9999)
+				<< ", \"max_ns\": " << histogram.max()
+				<< "}" << (result_index + 1 == results.size() ? "\n" : ",\n");
+		}
+
+		out << "]\n";
+	}
+
+	void write_json(std::ostream& out, const std::vector<benchmark_result>& results) {
+		out << "[\n";
+
+		for (size_t result_index{ 0 }; result_index < results.size(); ++result_index) {
+			const benchmark_result& result{ results[result_index] };
+			double operations{ static_cast<double>(result.operations == 0 ? 1 : result.operations) };
+
+			out << "  {\"name\": \"" << result.name << "\", \"operations\": " << result.operations
+				<< ", \"ns_per_op\": " << result.nanoseconds / operations << ", \"counters_per_op\": {";
+
+			for (size_t counter{ 0 }; counter < Byte::perf_counters::counter_count; ++counter) {
+				out << (counter == 0 ? "" : ", ") << '"' << Byte::perf_counter_names[counter] << "\": ";
+
+				if (result.counters[counter]) {
+					out << static_cast<double>(*result.counters[counter]) / operations;
+				}
+				else {
+					out << "null";
+				}
+			}
+
+			out << "}}" << (result_index + 1 == results.size() ? "\n" : ",\n");
+		}
+
+		out << "]\n";
+	}
+
+}
+
+int main(int argc, char** argv) {
+	benchmark_options options;
+
+	for (int argument{ 1 }; argument < argc; ++argument) {
+		if (std::strcmp(argv[argument], "--perf") == 0) {
+			options.perf = true;
+		}
+		else if (std::strcmp(argv[argument], "--latency") == 0) {
+			options.latency = true;
+		}
+		else if (std::strcmp(argv[argument], "--size") == 0 && argument + 1 < argc) {
+			options.size = std::strtoull(argv[++argument], nullptr, 10);
+		}
+		else if (std::strcmp(argv[argument], "--output") == 0 && argument + 1 < argc) {
+			options.output = argv[++argument];
+		}
+		else {
+			std::fprintf(stderr, "usage: %s [--size N] [--perf] [--latency] [--output FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::ofstream file;
+	if (!options.output.empty()) {
+		file.open(options.output);
+	}
+
+	std::ostream& out{ options.output.empty() ? std::cout : file };
+
+	if (options.latency) {
+		write_latency_json(out, run_latency(options));
+	}
+	else {
+		write_json(out, run(options));
+	}
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace Byte {
+
+	class latency_histogram {
+	private:
+		inline static constexpr size_t _SUB_BUCKET_BITS{ 7 };
+		inline static constexpr size_t _SUB_BUCKET_COUNT{ size_t{ 1 } << _SUB_BUCKET_BITS };
+		inline static constexpr size_t _HALF_COUNT{ _SUB_BUCKET_COUNT / 2 };
+		inline static constexpr size_t _BUCKET_COUNT{ _SUB_BUCKET_COUNT + (64 - _SUB_BUCKET_BITS) * _HALF_COUNT };
+
+	private:
+		std::vector<uint64_t> counts;
+		uint64_t _count{ 0 };
+		uint64_t _max{ 0 };
+		uint64_t _min{ std::numeric_limits<uint64_t>::max() };
+
+	public:
+		latency_histogram()
+			:counts(_BUCKET_COUNT, 0) {
+		}
+
+		void record(uint64_t value) {
+			++counts[bucket(value)];
+			++_count;
+			_max = std::max(_max, value);
+			_min = std::min(_min, value);
+		}
+
+		void merge(const latency_histogram& left) {
+			for (size_t index{ 0 }; index < _BUCKET_COUNT; ++index) {
+				counts[index] += left.counts[index];
+			}
+			_count += left._count;
+			_max = std::max(_max, left._max);
+			_min = std::min(_min, left._min);
+		}
+
+		uint64_t percentile(double quantile) const {
+			if (_count == 0) {
+				return 0;
+			}
+
+			uint64_t target{ static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(_count))) };
+			target = std::clamp<uint64_t>(target, 1, _count);
+
+			uint64_t seen{ 0 };
+			for (size_t index{ 0 }; index < _BUCKET_COUNT; ++index) {
+				seen += counts[index];
+				if (seen >= target) {
+					return std::min(highest_equivalent(index), _max);
+				}
+			}
+
+			return _max;
+		}
+
+		uint64_t count() const {
+			return _count;
+		}
+
+		uint64_t max() const {
+			return _max;
+		}
+
+		uint64_t min() const {
+			return _count == 0 ? 0 : _min;
+		}
+
+		void clear() {
+			std::fill(counts.begin(), counts.end(), 0);
+			_count = 0;
+			_max = 0;
+			_min = std::numeric_limits<uint64_t>::max();
+		}
+
+	private:
+		static size_t bucket(uint64_t value) {
+			if (value < _SUB_BUCKET_COUNT) {
+				return static_cast<size_t>(value);
+			}
+
+			size_t shift{ static_cast<size_t>(std::bit_width(value)) - _SUB_BUCKET_BITS };
+			return _SUB_BUCKET_COUNT + (shift - 1) * _HALF_COUNT + static_cast<size_t>((value >> shift) - _HALF_COUNT);
+		}
+
+		static uint64_t highest_equivalent(size_t index) {
+			if (index < _SUB_BUCKET_COUNT) {
+				return index;
+			}
+
+			size_t shift{ (index - _SUB_BUCKET_COUNT) / _HALF_COUNT + 1 };
+			uint64_t sub_bucket{ (index - _SUB_BUCKET_COUNT) % _HALF_COUNT + _HALF_COUNT };
+
+			return ((sub_bucket + 1) << shift) - 1;
+		}
+	};
+
+}
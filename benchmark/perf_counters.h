@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Byte {
+
+	enum class perf_counter : size_t {
+		cycles,
+		instructions,
+		cache_misses,
+		branch_misses,
+		dtlb_misses,
+		count
+	};
+
+	inline constexpr std::array<std::string_view, static_cast<size_t>(perf_counter::count)> perf_counter_names{
+		"cycles",
+		"instructions",
+		"cache_misses",
+		"branch_misses",
+		"dtlb_misses"
+	};
+
+	class perf_counters {
+	public:
+		inline static constexpr size_t counter_count{ static_cast<size_t>(perf_counter::count) };
+
+		using sample = std::array<std::optional<uint64_t>, counter_count>;
+
+	private:
+		std::array<int, counter_count> descriptors;
+
+	public:
+		perf_counters(bool enabled = true) {
+			descriptors.fill(-1);
+
+#if defined(__linux__)
+			if (!enabled) {
+				return;
+			}
+
+			open(perf_counter::cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+			open(perf_counter::instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+			open(perf_counter::cache_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			open(perf_counter::branch_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+			open(perf_counter::dtlb_misses, PERF_TYPE_HW_CACHE,
+				PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+			(void)enabled;
+#endif
+		}
+
+		perf_counters(const perf_counters&) = delete;
+
+		perf_counters& operator=(const perf_counters&) = delete;
+
+		~perf_counters() {
+#if defined(__linux__)
+			for (int descriptor : descriptors) {
+				if (descriptor >= 0) {
+					::close(descriptor);
+				}
+			}
+#endif
+		}
+
+		bool available() const {
+			for (int descriptor : descriptors) {
+				if (descriptor >= 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void start() {
+#if defined(__linux__)
+			for (int descriptor : descriptors) {
+				if (descriptor >= 0) {
+					::ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+					::ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif
+		}
+
+		sample stop() {
+			sample out;
+
+#if defined(__linux__)
+			for (int descriptor : descriptors) {
+				if (descriptor >= 0) {
+					::ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+				}
+			}
+
+			for (size_t counter{ 0 }; counter < counter_count; ++counter) {
+				uint64_t value{ 0 };
+
+				if (descriptors[counter] >= 0 && ::read(descriptors[counter], &value, sizeof(value)) == sizeof(value)) {
+					out[counter] = value;
+				}
+			}
+#endif
+
+			return out;
+		}
+
+	private:
+#if defined(__linux__)
+		void open(perf_counter counter, uint32_t type, uint64_t config) {
+			perf_event_attr attributes{};
+
+			attributes.size = sizeof(perf_event_attr);
+			attributes.type = type;
+			attributes.config = config;
+			attributes.disabled = 1;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+
+			long descriptor{ ::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0) };
+			descriptors[static_cast<size_t>(counter)] = static_cast<int>(descriptor);
+		}
+#endif
+	};
+
+}
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../sparse_vector.h"
+#include "../sparse_trace.h"
+#include "latency_histogram.h"
+
+namespace {
+
+	using clock_type = std::chrono::steady_clock;
+
+	inline constexpr size_t npos{ std::numeric_limits<size_t>::max() };
+	inline constexpr size_t operation_count{ 5 };
+
+	inline constexpr std::array<const char*, operation_count> operation_names{
+		"push",
+		"insert",
+		"erase",
+		"grow",
+		"iterate"
+	};
+
+	struct replay_options {
+		std::string trace_path;
+		std::string synthesize_path;
+		std::string output;
+		size_t size{ 1 << 20 };
+	};
+
+	struct replay_result {
+		std::string name;
+		size_t operations{ 0 };
+		double seconds{ 0.0 };
+		std::array<Byte::latency_histogram, operation_count> histograms;
+	};
+
+	volatile uint64_t sink_value{ 0 };
+
+	template<typename Container>
+	replay_result replay(const std::string& name, const Byte::operation_trace& trace, Container& container) {
+		replay_result result{ name, 0, 0.0, {} };
+		std::vector<size_t> slots;
+
+		auto slot{ [&](uint64_t index) -> size_t& {
+			if (index >= slots.size()) {
+				slots.resize(std::max<size_t>(index + 1, 2 * slots.size()), npos);
+			}
+			return slots[index];
+		} };
+
+		clock_type::time_point start{ clock_type::now() };
+
+		trace.for_each([&](const Byte::trace_event& event) {
+			Byte::latency_histogram& histogram{ result.histograms[static_cast<size_t>(event.operation)] };
+			clock_type::time_point begin{ clock_type::now() };
+
+			switch (event.operation) {
+			case Byte::trace_operation::push:
+				slot(event.index) = container.push(event.index);
+				break;
+			case Byte::trace_operation::insert:
+				container.reserve(event.index + 1);
+				if (container.test(event.index)) {
+					container[event.index] = event.index;
+				}
+				else {
+					container.insert(event.index, event.index);
+				}
+				slot(event.index) = event.index;
+				break;
+			case Byte::trace_operation::erase: {
+				size_t& target{ slot(event.index) };
+				if (target != npos && target < container.capacity() && container.test(target)) {
+					container.erase(target);
+				}
+				target = npos;
+				break;
+			}
+			case Byte::trace_operation::grow:
+				return;
+			case Byte::trace_operation::iterate: {
+				uint64_t sum{ 0 };
+				for (const auto& value : container) {
+					sum += value;
+				}
+				sink_value = sum;
+				break;
+			}
+			}
+
+			clock_type::time_point end{ clock_type::now() };
+			histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+			++result.operations;
+		});
+
+		result.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+		return result;
+	}
+
+	size_t max_index(const Byte::operation_trace& trace) {
+		size_t out{ 0 };
+		trace.for_each([&](const Byte::trace_event& event) {
+			if (event.operation == Byte::trace_operation::push || event.operation == Byte::trace_operation::insert) {
+				out = std::max<size_t>(out, event.index + 1);
+			}
+		});
+		return out;
+	}
+
+	void synthesize(const replay_options& options) {
+		using traced_vector = Byte::sparse_vector<uint64_t, std::allocator<uint64_t>, Byte::trace_observer>;
+
+		Byte::operation_trace trace;
+		traced_vector values{ Byte::_BITSET_SIZE, Byte::trace_observer{ trace } };
+		std::vector<size_t> live;
+		std::mt19937_64 rng{ 42 };
+
+		for (size_t operation{ 0 }; operation < options.size; ++operation) {
+			uint64_t choice{ rng() % 100 };
+
+			if (choice < 55 || live.empty()) {
+				live.push_back(values.push(operation));
+			}
+			else if (choice < 99) {
+				size_t position{ static_cast<size_t>(rng() % live.size()) };
+				values.erase(live[position]);
+				live[position] = live.back();
+				live.pop_back();
+			}
+			else {
+				uint64_t sum{ 0 };
+				for (uint64_t value : values) {
+					sum += value;
+				}
+				sink_value = sum;
+			}
+		}
+
+		trace.save(options.synthesize_path);
+		std::fprintf(stderr, "wrote %zu operations in %zu bytes\n", trace.size(), trace.bytes());
+	}
+
+	void write_json(std::ostream& out, const std::vector<replay_result>& results) {
+		out << "[\n";
+
+		for (size_t result_index{ 0 }; result_index < results.size(); ++result_index) {
+			const replay_result& result{ results[result_index] };
+
+			out << "  {\"name\": \"" << result.name << "\", \"operations\": " << result.operations
+				<< ", \"seconds\": " << result.seconds
+				<< ", \"ops_per_second\": " << (result.seconds > 0.0 ? static_cast<double>(result.operations) / result.seconds : 0.0)
+				<< ", \"latency_ns\": {";
+
+			bool first{ true };
+			for (size_t operation{ 0 }; operation < operation_count; ++operation) {
+				const Byte::latency_histogram& histogram{ result.histograms[operation] };
+
+				if (histogram.count() == 0) {
+					continue;
+				}
+
+				out << (first ? "" : ", ") << '"' << operation_names[operation] << "\": {\"count\": " << histogram.count()
+					<< ", \"p50\": " << histogram.percentile(0.5)
+					<< ", \"p99\": " << histogram.percentile(0.99)
+					<< ", \"p99_9\": " << histogram.percentile(0.999)
+					<< ", \"max\": " << histogram.max() << "}";
+				first = false;
+			}
+
+			out << "}}" << (result_index + 1 == results.size() ? "\n" : ",\n");
+		}
+
+		out << "]\n";
+	}
+
+}
+
+int main(int argc, char** argv) {
+	replay_options options;
+
+	for (int argument{ 1 }; argument < argc; ++argument) {
+		if (std::strcmp(argv[argument], "--trace") == 0 && argument + 1 < argc) {
+			options.trace_path = argv[++argument];
+		}
+		else if (std::strcmp(argv[argument], "--synthesize") == 0 && argument + 1 < argc) {
+			options.synthesize_path = argv[++argument];
+		}
+		else if (std::strcmp(argv[argument], "--size") == 0 && argument + 1 < argc) {
+			options.size = std::strtoull(argv[++argument], nullptr, 10);
+		}
+		else if (std::strcmp(argv[argument], "--output") == 0 && argument + 1 < argc) {
+			options.output = argv[++argument];
+		}
+		else {
+			std::fprintf(stderr, "usage: %s --trace FILE [--output FILE] | --synthesize FILE [--size N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (!options.synthesize_path.empty()) {
+		synthesize(options);
+		return 0;
+	}
+
+	if (options.trace_path.empty()) {
+		std::fprintf(stderr, "usage: %s --trace FILE [--output FILE] | --synthesize FILE [--size N]\n", argv[0]);
+		return 1;
+	}
+
+	Byte::operation_trace trace{ Byte::operation_trace::load(options.trace_path) };
+	std::vector<replay_result> results;
+
+	{
+		Byte::sparse_vector<uint64_t> values;
+		results.push_back(replay("default", trace, values));
+	}
+
+	{
+		Byte::sparse_vector<uint64_t> values{ max_index(trace) };
+		results.push_back(replay("presized", trace, values));
+	}
+
+	std::ofstream file;
+	if (!options.output.empty()) {
+		file.open(options.output);
+	}
+
+	write_json(options.output.empty() ? std::cout : file, results);
+
+	return 0;
+}
@@ -0,0 +1,802 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <concepts>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <span>
+#include <cmath>
+#include <utility>
+#include <optional>
+#include <stdexcept>
+
+#include "sparse_vector.h"
+#include "sparse_map.h"
+
+namespace Byte {
+
+	inline static constexpr size_t _RADIX_BITS{ 8 };
+	inline static constexpr size_t _RADIX_BUCKETS{ size_t{ 1 } << _RADIX_BITS };
+
+	template<typename T>
+	inline constexpr bool radix_sortable{ sizeof(T) <= sizeof(uint64_t) && (std::is_integral<T>::value || (std::is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8))) };
+
+	template<typename T>
+	uint64_t radix_key(T value) {
+		if constexpr (std::is_floating_point<T>::value) {
+			using bits_type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+			bits_type bits{ std::bit_cast<bits_type>(value == T{ 0 } ? T{ 0 } : value) };
+			bits_type sign{ bits_type{ 1 } << (8 * sizeof(T) - 1) };
+
+			return static_cast<uint64_t>((bits & sign) != 0 ? ~bits : bits | sign);
+		}
+		else if constexpr (std::is_signed<T>::value) {
+			using bits_type = std::make_unsigned_t<T>;
+			return static_cast<uint64_t>(static_cast<bits_type>(static_cast<bits_type>(value) ^ (bits_type{ 1 } << (8 * sizeof(T) - 1))));
+		}
+		else {
+			return static_cast<uint64_t>(value);
+		}
+	}
+
+	template<typename Container>
+	size_t block_thread_count(const Container& container, size_t thread_count) {
+		return std::max<size_t>(std::min(thread_count == 0 ? default_thread_count() : thread_count, container.block_count()), 1);
+	}
+
+	template<typename Container, typename Fn>
+	void for_each_live_block(const Container& container, size_t thread_count, Fn&& fn) {
+		parallel_for(container.block_count(), block_thread_count(container, thread_count), [&](size_t thread_index, size_t begin, size_t end) {
+			for (size_t bitset_index{ begin }; bitset_index < end; ++bitset_index) {
+				for (uint64_t _bitset{ container.block(bitset_index).to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+					fn(thread_index, bitset_index * _BITSET_SIZE + std::countr_zero(_bitset));
+				}
+			}
+		});
+	}
+
+	template<typename Container, typename Make>
+	auto gather_live(const Container& container, size_t thread_count, Make&& make) {
+		using item_type = decltype(make(size_t{ 0 }));
+
+		thread_count = block_thread_count(container, thread_count);
+		std::vector<size_t> offsets(thread_count + 1, 0);
+
+		parallel_for(container.block_count(), thread_count, [&](size_t thread_index, size_t begin, size_t end) {
+			for (size_t bitset_index{ begin }; bitset_index < end; ++bitset_index) {
+				offsets[thread_index + 1] += container.block(bitset_index).count();
+			}
+		});
+
+		for (size_t thread_index{ 0 }; thread_index < thread_count; ++thread_index) {
+			offsets[thread_index + 1] += offsets[thread_index];
+		}
+
+		std::vector<item_type> out(offsets.back());
+
+		for_each_live_block(container, thread_count, [&](size_t thread_index, size_t index) {
+			out[offsets[thread_index]++] = make(index);
+		});
+
+		return out;
+	}
+
+	template<typename Container>
+	std::vector<size_t> live_indices(const Container& container, size_t thread_count = 0) {
+		return gather_live(container, thread_count, [](size_t index) {
+			return index;
+		});
+	}
+
+	template<typename Container, typename Compare = std::less<>>
+	std::vector<size_t> sorted_indices(const Container& container, Compare comp = Compare{}, size_t thread_count = 0) {
+		using value_type = typename Container::value_type;
+
+		constexpr bool ascending{ std::is_same<Compare, std::less<>>::value || std::is_same<Compare, std::less<value_type>>::value };
+		constexpr bool descending{ std::is_same<Compare, std::greater<>>::value || std::is_same<Compare, std::greater<value_type>>::value };
+
+		thread_count = thread_count == 0 ? default_thread_count() : thread_count;
+
+		if constexpr (radix_sortable<value_type> && (ascending || descending)) {
+			struct radix_item {
+				uint64_t key;
+				size_t index;
+			};
+
+			std::vector<radix_item> items{ gather_live(container, thread_count, [&](size_t index) {
+				uint64_t key{ radix_key(container[index]) };
+				return radix_item{ descending ? ~key : key, index };
+			}) };
+
+			size_t count{ items.size() };
+			size_t pass_threads{ std::max<size_t>(std::min(thread_count, count), 1) };
+			std::vector<radix_item> buffer(count);
+			std::vector<std::array<size_t, _RADIX_BUCKETS>> histograms(pass_threads);
+
+			for (size_t shift{ 0 }; shift < 8 * sizeof(value_type); shift += _RADIX_BITS) {
+				for (std::array<size_t, _RADIX_BUCKETS>& histogram : histograms) {
+					histogram.fill(0);
+				}
+
+				parallel_for(count, pass_threads, [&](size_t thread_index, size_t begin, size_t end) {
+					for (size_t position{ begin }; position < end; ++position) {
+						++histograms[thread_index][(items[position].key >> shift) & (_RADIX_BUCKETS - 1)];
+					}
+				});
+
+				size_t offset{ 0 };
+				bool uniform{ false };
+
+				for (size_t digit{ 0 }; digit < _RADIX_BUCKETS; ++digit) {
+					size_t digit_count{ 0 };
+
+					for (std::array<size_t, _RADIX_BUCKETS>& histogram : histograms) {
+						size_t bucket_count{ histogram[digit] };
+						histogram[digit] = offset;
+						offset += bucket_count;
+						digit_count += bucket_count;
+					}
+
+					uniform = uniform || digit_count == count;
+				}
+
+				if (uniform) {
+					continue;
+				}
+
+				parallel_for(count, pass_threads, [&](size_t thread_index, size_t begin, size_t end) {
+					for (size_t position{ begin }; position < end; ++position) {
+						buffer[histograms[thread_index][(items[position].key >> shift) & (_RADIX_BUCKETS - 1)]++] = items[position];
+					}
+				});
+
+				items.swap(buffer);
+			}
+
+			std::vector<size_t> out(count);
+			parallel_for(count, pass_threads, [&](size_t, size_t begin, size_t end) {
+				for (size_t position{ begin }; position < end; ++position) {
+					out[position] = items[position].index;
+				}
+			});
+
+			return out;
+		}
+		else {
+			std::vector<size_t> indices{ live_indices(container, thread_count) };
+			size_t count{ indices.size() };
+			size_t run_count{ std::max<size_t>(std::min(thread_count, count), 1) };
+
+			auto less{ [&](size_t left, size_t right) {
+				return comp(container[left], container[right]);
+			} };
+
+			std::vector<size_t> bounds(run_count + 1);
+			for (size_t run{ 0 }; run <= run_count; ++run) {
+				bounds[run] = count * run / run_count;
+			}
+
+			parallel_for(run_count, run_count, [&](size_t, size_t begin, size_t end) {
+				for (size_t run{ begin }; run < end; ++run) {
+					std::stable_sort(indices.begin() + bounds[run], indices.begin() + bounds[run + 1], less);
+				}
+			});
+
+			std::vector<size_t> buffer(count);
+
+			while (bounds.size() > 2) {
+				size_t pair_count{ (bounds.size() - 1) / 2 };
+				size_t odd{ (bounds.size() - 1) % 2 };
+
+				parallel_for(pair_count + odd, thread_count, [&](size_t, size_t begin, size_t end) {
+					for (size_t pair{ begin }; pair < end; ++pair) {
+						size_t first{ bounds[2 * pair] };
+						size_t middle{ bounds[std::min(2 * pair + 1, bounds.size() - 1)] };
+						size_t last{ bounds[std::min(2 * pair + 2, bounds.size() - 1)] };
+
+						std::merge(indices.begin() + first, indices.begin() + middle, indices.begin() + middle, indices.begin() + last, buffer.begin() + first, less);
+					}
+				});
+
+				std::vector<size_t> merged;
+				for (size_t bound{ 0 }; bound < bounds.size(); bound += 2) {
+					merged.push_back(bounds[bound]);
+				}
+				if (merged.back() != count) {
+					merged.push_back(count);
+				}
+
+				bounds.swap(merged);
+				indices.swap(buffer);
+			}
+
+			return indices;
+		}
+	}
+
+	template<typename Container, typename Compare = std::less<>>
+	std::vector<typename Container::value_type> sort_gather(const Container& container, Compare comp = Compare{}, size_t thread_count = 0) {
+		using value_type = typename Container::value_type;
+
+		std::vector<size_t> indices{ sorted_indices(container, comp, thread_count) };
+
+		if constexpr (std::default_initializable<value_type> && std::is_copy_assignable<value_type>::value) {
+			std::vector<value_type> out(indices.size());
+
+			parallel_for(indices.size(), thread_count, [&](size_t, size_t begin, size_t end) {
+				for (size_t position{ begin }; position < end; ++position) {
+					out[position] = container[indices[position]];
+				}
+			});
+
+			return out;
+		}
+		else {
+			std::vector<value_type> out;
+			out.reserve(indices.size());
+
+			for (size_t index : indices) {
+				out.push_back(container[index]);
+			}
+
+			return out;
+		}
+	}
+
+	template<typename Container, typename Key = std::identity>
+	std::vector<size_t> top_k(const Container& container, size_t k, Key key = Key{}, size_t thread_count = 0) {
+		using key_type = std::decay_t<std::invoke_result_t<Key&, const typename Container::value_type&>>;
+		using entry = std::pair<key_type, size_t>;
+
+		auto better{ [](const entry& left, const entry& right) {
+			return right.first < left.first || (!(left.first < right.first) && left.second < right.second);
+		} };
+
+		if (k == 0) {
+			return {};
+		}
+
+		thread_count = block_thread_count(container, thread_count);
+		std::vector<std::vector<entry>> heaps(thread_count);
+
+		for_each_live_block(container, thread_count, [&](size_t thread_index, size_t index) {
+			std::vector<entry>& heap{ heaps[thread_index] };
+			entry candidate{ std::invoke(key, container[index]), index };
+
+			if (heap.size() < k) {
+				heap.push_back(std::move(candidate));
+				std::push_heap(heap.begin(), heap.end(), better);
+			}
+			else if (better(candidate, heap.front())) {
+				std::pop_heap(heap.begin(), heap.end(), better);
+				heap.back() = std::move(candidate);
+				std::push_heap(heap.begin(), heap.end(), better);
+			}
+		});
+
+		std::vector<entry> merged{ std::move(heaps[0]) };
+		for (size_t thread_index{ 1 }; thread_index < thread_count; ++thread_index) {
+			merged.insert(merged.end(), std::make_move_iterator(heaps[thread_index].begin()), std::make_move_iterator(heaps[thread_index].end()));
+		}
+
+		size_t count{ std::min(k, merged.size()) };
+		std::partial_sort(merged.begin(), merged.begin() + count, merged.end(), better);
+
+		std::vector<size_t> out(count);
+		for (size_t position{ 0 }; position < count; ++position) {
+			out[position] = merged[position].second;
+		}
+
+		return out;
+	}
+
+	template<typename Container, typename Key = std::identity>
+	auto quantiles(const Container& container, std::span<const double> qs, Key key = Key{}, size_t thread_count = 0) {
+		using key_type = std::decay_t<std::invoke_result_t<Key&, const typename Container::value_type&>>;
+
+		std::vector<key_type> keys{ gather_live(container, thread_count, [&](size_t index) {
+			return std::invoke(key, container[index]);
+		}) };
+
+		std::vector<key_type> out;
+		if (keys.empty()) {
+			return out;
+		}
+
+		std::vector<size_t> ranks(qs.size());
+		for (size_t position{ 0 }; position < qs.size(); ++position) {
+			double rank{ std::ceil(std::clamp(qs[position], 0.0, 1.0) * static_cast<double>(keys.size())) };
+			ranks[position] = std::max<size_t>(static_cast<size_t>(rank), 1) - 1;
+		}
+
+		std::vector<size_t> order(ranks);
+		std::sort(order.begin(), order.end());
+		order.erase(std::unique(order.begin(), order.end()), order.end());
+
+		size_t depth{ static_cast<size_t>(std::bit_width(thread_count == 0 ? default_thread_count() : thread_count)) };
+
+		auto select{ [&](auto& self, size_t begin, size_t end, size_t rank_begin, size_t rank_end, size_t level) -> void {
+			if (rank_begin == rank_end) {
+				return;
+			}
+
+			size_t middle{ (rank_begin + rank_end) / 2 };
+			size_t rank{ order[middle] };
+
+			std::nth_element(keys.begin() + begin, keys.begin() + rank, keys.begin() + end);
+
+			if (level + 1 < depth) {
+				parallel_for(2, 2, [&](size_t side, size_t, size_t) {
+					if (side == 0) {
+						self(self, begin, rank, rank_begin, middle, level + 1);
+					}
+					else {
+						self(self, rank + 1, end, middle + 1, rank_end, level + 1);
+					}
+				});
+			}
+			else {
+				self(self, begin, rank, rank_begin, middle, level + 1);
+				self(self, rank + 1, end, middle + 1, rank_end, level + 1);
+			}
+		} };
+
+		select(select, 0, keys.size(), 0, order.size(), 0);
+
+		out.reserve(ranks.size());
+		for (size_t rank : ranks) {
+			out.push_back(keys[rank]);
+		}
+
+		return out;
+	}
+
+	inline static constexpr size_t _HISTOGRAM_LANES{ 4 };
+
+	struct count_monoid {
+		size_t identity() const {
+			return 0;
+		}
+
+		template<typename T>
+		void add(size_t& accumulator, const T&) const {
+			++accumulator;
+		}
+
+		void merge(size_t& accumulator, size_t other) const {
+			accumulator += other;
+		}
+	};
+
+	template<typename Accumulator, typename Fn>
+	struct sum_monoid {
+		Fn fn;
+
+		Accumulator identity() const {
+			return Accumulator{};
+		}
+
+		template<typename T>
+		void add(Accumulator& accumulator, const T& value) const {
+			accumulator += std::invoke(fn, value);
+		}
+
+		void merge(Accumulator& accumulator, const Accumulator& other) const {
+			accumulator += other;
+		}
+	};
+
+	template<typename Accumulator, typename Fn>
+	sum_monoid<Accumulator, Fn> sum_of(Fn fn) {
+		return sum_monoid<Accumulator, Fn>{ std::move(fn) };
+	}
+
+	template<typename Container, typename KeyFn, typename Monoid>
+	auto group_aggregate(const Container& container, KeyFn key_fn, Monoid monoid, size_t thread_count = 0) {
+		using key_type = std::decay_t<std::invoke_result_t<KeyFn&, const typename Container::value_type&>>;
+		using accumulator_type = decltype(monoid.identity());
+
+		static_assert(std::is_integral<key_type>::value || std::is_enum<key_type>::value, "group_aggregate keys must be integers or enums");
+
+		using map_key = std::conditional_t<std::is_enum<key_type>::value, std::underlying_type<key_type>, std::type_identity<key_type>>::type;
+		using table_type = sparse_map<map_key, accumulator_type>;
+
+		thread_count = block_thread_count(container, thread_count);
+		std::vector<table_type> tables(thread_count);
+
+		auto accumulator{ [&](table_type& table, map_key key) -> accumulator_type& {
+			accumulator_type* out{ table.find(key) };
+			if (!out) {
+				table.emplace(key, monoid.identity());
+				out = table.find(key);
+			}
+			return *out;
+		} };
+
+		for_each_live_block(container, thread_count, [&](size_t thread_index, size_t index) {
+			const auto& value{ container[index] };
+			monoid.add(accumulator(tables[thread_index], static_cast<map_key>(std::invoke(key_fn, value))), value);
+		});
+
+		for (size_t thread_index{ 1 }; thread_index < thread_count; ++thread_index) {
+			for (auto [key, other] : tables[thread_index]) {
+				monoid.merge(accumulator(tables[0], key), other);
+			}
+		}
+
+		std::vector<std::pair<key_type, accumulator_type>> out;
+		out.reserve(tables[0].size());
+
+		for (auto [key, total] : tables[0]) {
+			out.emplace_back(static_cast<key_type>(key), std::move(total));
+		}
+
+		std::sort(out.begin(), out.end(), [](const auto& left, const auto& right) {
+			return left.first < right.first;
+		});
+
+		return out;
+	}
+
+	template<typename Container, typename KeyFn>
+	std::vector<uint64_t> histogram(const Container& container, size_t bin_count, KeyFn key_fn, size_t thread_count = 0) {
+		using key_type = std::decay_t<std::invoke_result_t<KeyFn&, const typename Container::value_type&>>;
+
+		static_assert(std::is_integral<key_type>::value, "histogram bins must be integers; use the edges overload for other keys");
+
+		thread_count = block_thread_count(container, thread_count);
+		std::vector<std::vector<uint64_t>> lanes(thread_count, std::vector<uint64_t>(_HISTOGRAM_LANES * bin_count, 0));
+
+		parallel_for(container.block_count(), thread_count, [&](size_t thread_index, size_t begin, size_t end) {
+			uint64_t* counts{ lanes[thread_index].data() };
+			uint64_t bins[_BITSET_SIZE];
+
+			for (size_t bitset_index{ begin }; bitset_index < end; ++bitset_index) {
+				size_t count{ 0 };
+
+				for (uint64_t _bitset{ container.block(bitset_index).to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+					key_type key{ std::invoke(key_fn, container[bitset_index * _BITSET_SIZE + std::countr_zero(_bitset)]) };
+					bins[count] = static_cast<uint64_t>(key);
+					count += static_cast<uint64_t>(key) < bin_count;
+				}
+
+				size_t position{ 0 };
+				for (; position + _HISTOGRAM_LANES <= count; position += _HISTOGRAM_LANES) {
+					for (size_t lane{ 0 }; lane < _HISTOGRAM_LANES; ++lane) {
+						++counts[bins[position + lane] * _HISTOGRAM_LANES + lane];
+					}
+				}
+				for (; position < count; ++position) {
+					++counts[bins[position] * _HISTOGRAM_LANES];
+				}
+			}
+		});
+
+		std::vector<uint64_t> out(bin_count, 0);
+		for (const std::vector<uint64_t>& counts : lanes) {
+			for (size_t bin{ 0 }; bin < bin_count; ++bin) {
+				for (size_t lane{ 0 }; lane < _HISTOGRAM_LANES; ++lane) {
+					out[bin] += counts[bin * _HISTOGRAM_LANES + lane];
+				}
+			}
+		}
+
+		return out;
+	}
+
+	template<typename Container, std::ranges::random_access_range Edges, typename KeyFn>
+		requires std::ranges::sized_range<Edges>
+	std::vector<uint64_t> histogram(const Container& container, const Edges& edges, KeyFn key_fn, size_t thread_count = 0) {
+		size_t edge_count{ static_cast<size_t>(std::ranges::size(edges)) };
+		size_t bin_count{ edge_count < 2 ? 0 : edge_count - 1 };
+		auto _begin{ std::ranges::begin(edges) };
+
+		return histogram(container, bin_count, [&](const auto& value) -> size_t {
+			auto key{ std::invoke(key_fn, value) };
+			size_t upper{ static_cast<size_t>(std::upper_bound(_begin, _begin + edge_count, key) - _begin) };
+			return upper == 0 || upper > bin_count ? bin_count : upper - 1;
+		}, thread_count);
+	}
+
+	inline static constexpr size_t _JOIN_PARTITION_BYTES{ 256 * 1024 };
+	inline static constexpr size_t _JOIN_PARTITION_LIMIT{ 4096 };
+	inline static constexpr size_t _JOIN_BATCH{ 16 };
+
+	inline void prefetch(const void* address) {
+#if defined(__GNUC__)
+		__builtin_prefetch(address);
+#else
+		(void)address;
+#endif
+	}
+
+	struct join_hash {
+		template<typename K>
+		size_t operator()(const K& key) const {
+			if constexpr (std::is_integral<K>::value || std::is_enum<K>::value) {
+				return integer_hash{}(static_cast<uint64_t>(key));
+			}
+			else {
+				return integer_hash{}(static_cast<uint64_t>(std::hash<K>{}(key)));
+			}
+		}
+	};
+
+	template<typename K, typename Hash = join_hash>
+	class join_table {
+	private:
+		struct entry {
+			size_t hash;
+			K key;
+			size_t slot;
+		};
+
+	private:
+		std::vector<entry> entries;
+		std::vector<size_t> partitions;
+		std::vector<size_t> buckets;
+		std::vector<size_t> bucket_bases;
+		std::vector<size_t> bucket_masks;
+		size_t partition_bits{ 0 };
+		Hash hasher;
+
+	public:
+		join_table(Hash hash = Hash{})
+			:hasher{ std::move(hash) } {
+		}
+
+		template<typename Container, typename KeyFn>
+		void build(const Container& container, KeyFn key_fn, size_t thread_count = 0) {
+			thread_count = thread_count == 0 ? default_thread_count() : thread_count;
+
+			std::vector<entry> items{ gather_live(container, thread_count, [&](size_t index) {
+				K key{ std::invoke(key_fn, container[index]) };
+				size_t hash{ hasher(key) };
+				return entry{ hash, std::move(key), index };
+			}) };
+
+			size_t count{ items.size() };
+			size_t partition_count{ std::min(std::bit_ceil(std::max<size_t>(count * sizeof(entry) / _JOIN_PARTITION_BYTES, 1)), _JOIN_PARTITION_LIMIT) };
+			size_t pass_threads{ std::max<size_t>(std::min(thread_count, count), 1) };
+
+			partition_bits = static_cast<size_t>(std::countr_zero(partition_count));
+
+			std::vector<std::vector<size_t>> offsets(pass_threads, std::vector<size_t>(partition_count, 0));
+
+			parallel_for(count, pass_threads, [&](size_t thread_index, size_t begin, size_t end) {
+				for (size_t position{ begin }; position < end; ++position) {
+					++offsets[thread_index][partition_of(items[position].hash)];
+				}
+			});
+
+			partitions.assign(partition_count + 1, 0);
+
+			size_t offset{ 0 };
+			for (size_t partition{ 0 }; partition < partition_count; ++partition) {
+				partitions[partition] = offset;
+				for (std::vector<size_t>& thread_offsets : offsets) {
+					size_t partition_size{ thread_offsets[partition] };
+					thread_offsets[partition] = offset;
+					offset += partition_size;
+				}
+			}
+			partitions[partition_count] = offset;
+
+			std::vector<entry> partitioned(count);
+
+			parallel_for(count, pass_threads, [&](size_t thread_index, size_t begin, size_t end) {
+				for (size_t position{ begin }; position < end; ++position) {
+					partitioned[offsets[thread_index][partition_of(items[position].hash)]++] = std::move(items[position]);
+				}
+			});
+
+			entries.resize(count);
+			bucket_bases.assign(partition_count + 1, 0);
+			bucket_masks.assign(partition_count, 0);
+
+			for (size_t partition{ 0 }; partition < partition_count; ++partition) {
+				size_t bucket_count{ std::bit_ceil(std::max<size_t>(partitions[partition + 1] - partitions[partition], 1)) };
+				bucket_masks[partition] = bucket_count - 1;
+				bucket_bases[partition + 1] = bucket_bases[partition] + bucket_count + 1;
+			}
+
+			buckets.assign(bucket_bases.back(), 0);
+
+			parallel_for(partition_count, thread_count, [&](size_t, size_t begin, size_t end) {
+				for (size_t partition{ begin }; partition < end; ++partition) {
+					size_t* heads{ buckets.data() + bucket_bases[partition] };
+					size_t mask{ bucket_masks[partition] };
+
+					for (size_t position{ partitions[partition] }; position < partitions[partition + 1]; ++position) {
+						++heads[(partitioned[position].hash & mask) + 1];
+					}
+
+					heads[0] = partitions[partition];
+					for (size_t bucket{ 0 }; bucket <= mask; ++bucket) {
+						heads[bucket + 1] += heads[bucket];
+					}
+
+					for (size_t position{ partitions[partition] }; position < partitions[partition + 1]; ++position) {
+						size_t bucket{ partitioned[position].hash & mask };
+						entries[heads[bucket]++] = std::move(partitioned[position]);
+					}
+
+					for (size_t bucket{ mask + 1 }; bucket > 0; --bucket) {
+						heads[bucket] = heads[bucket - 1];
+					}
+					heads[0] = partitions[partition];
+				}
+			});
+		}
+
+		size_t size() const {
+			return entries.size();
+		}
+
+		size_t partition_count() const {
+			return partitions.empty() ? 0 : partitions.size() - 1;
+		}
+
+		template<typename ProbeRange, typename ProbeKeyFn, typename Emit>
+		void probe(const ProbeRange& probes, ProbeKeyFn probe_key, Emit&& emit, size_t thread_count = 0) const {
+			if (entries.empty()) {
+				return;
+			}
+
+			auto _begin{ std::ranges::begin(probes) };
+			size_t probe_count{ static_cast<size_t>(std::ranges::size(probes)) };
+
+			parallel_for(probe_count, thread_count, [&](size_t, size_t begin, size_t end) {
+				size_t hashes[_JOIN_BATCH];
+				const size_t* heads[_JOIN_BATCH];
+
+				for (size_t batch{ begin }; batch < end; batch += _JOIN_BATCH) {
+					size_t batch_size{ std::min(_JOIN_BATCH, end - batch) };
+
+					for (size_t lane{ 0 }; lane < batch_size; ++lane) {
+						hashes[lane] = hasher(std::invoke(probe_key, _begin[batch + lane]));
+
+						size_t partition{ partition_of(hashes[lane]) };
+						heads[lane] = buckets.data() + bucket_bases[partition] + (hashes[lane] & bucket_masks[partition]);
+						prefetch(heads[lane]);
+					}
+
+					for (size_t lane{ 0 }; lane < batch_size; ++lane) {
+						prefetch(entries.data() + heads[lane][0]);
+					}
+
+					for (size_t lane{ 0 }; lane < batch_size; ++lane) {
+						const auto& probe{ _begin[batch + lane] };
+						const auto& key{ std::invoke(probe_key, probe) };
+
+						for (size_t position{ heads[lane][0] }; position < heads[lane][1]; ++position) {
+							const entry& candidate{ entries[position] };
+
+							if (candidate.hash == hashes[lane] && candidate.key == key) {
+								emit(candidate.slot, probe);
+							}
+						}
+					}
+				}
+			});
+		}
+
+	private:
+		size_t partition_of(size_t hash) const {
+			return partition_bits == 0 ? 0 : hash >> (8 * sizeof(size_t) - partition_bits);
+		}
+	};
+
+	template<typename Container, typename BuildKeyFn, typename ProbeRange, typename ProbeKeyFn, typename Emit>
+	void hash_join(const Container& container, BuildKeyFn build_key, const ProbeRange& probes, ProbeKeyFn probe_key, Emit&& emit, size_t thread_count = 0) {
+		using key_type = std::decay_t<std::invoke_result_t<BuildKeyFn&, const typename Container::value_type&>>;
+
+		join_table<key_type> table;
+		table.build(container, build_key, thread_count);
+		table.probe(probes, probe_key, emit, thread_count);
+	}
+
+	template<typename Accumulator, typename Container, typename BinaryOp, typename Write>
+	void scan_live(Container& container, std::optional<Accumulator> init, BinaryOp op, size_t thread_count, Write write) {
+		bool inclusive{ !init.has_value() };
+
+		thread_count = block_thread_count(container, thread_count);
+		std::vector<std::optional<Accumulator>> totals(thread_count);
+		std::vector<size_t> ranks(thread_count + 1, 0);
+
+		parallel_for(container.block_count(), thread_count, [&](size_t thread_index, size_t begin, size_t end) {
+			std::optional<Accumulator>& total{ totals[thread_index] };
+
+			for (size_t bitset_index{ begin }; bitset_index < end; ++bitset_index) {
+				uint64_t _bitset{ container.block(bitset_index).to_ullong() };
+				ranks[thread_index + 1] += std::popcount(_bitset);
+
+				for (; _bitset != 0; _bitset &= _bitset - 1) {
+					const auto& value{ container[bitset_index * _BITSET_SIZE + std::countr_zero(_bitset)] };
+					total = total ? static_cast<Accumulator>(op(std::move(*total), value)) : static_cast<Accumulator>(value);
+				}
+			}
+		});
+
+		std::vector<std::optional<Accumulator>> carries(thread_count);
+		std::optional<Accumulator> carry{ std::move(init) };
+
+		for (size_t thread_index{ 0 }; thread_index < thread_count; ++thread_index) {
+			carries[thread_index] = carry;
+			ranks[thread_index + 1] += ranks[thread_index];
+
+			if (totals[thread_index]) {
+				carry = carry ? static_cast<Accumulator>(op(std::move(*carry), std::move(*totals[thread_index]))) : std::move(*totals[thread_index]);
+			}
+		}
+
+		parallel_for(container.block_count(), thread_count, [&](size_t thread_index, size_t begin, size_t end) {
+			std::optional<Accumulator> accumulator{ std::move(carries[thread_index]) };
+			size_t rank{ ranks[thread_index] };
+
+			for (size_t bitset_index{ begin }; bitset_index < end; ++bitset_index) {
+				for (uint64_t _bitset{ container.block(bitset_index).to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+					size_t index{ bitset_index * _BITSET_SIZE + std::countr_zero(_bitset) };
+
+					if (inclusive) {
+						accumulator = accumulator ? static_cast<Accumulator>(op(std::move(*accumulator), container[index])) : static_cast<Accumulator>(container[index]);
+						write(rank++, index, *accumulator);
+					}
+					else {
+						Accumulator next{ static_cast<Accumulator>(op(*accumulator, container[index])) };
+						write(rank++, index, *accumulator);
+						accumulator = std::move(next);
+					}
+				}
+			}
+		});
+	}
+
+	template<typename Container, typename BinaryOp = std::plus<>>
+		requires std::invocable<BinaryOp&, typename Container::value_type, const typename Container::value_type&>
+	void inclusive_scan(Container& container, BinaryOp op = BinaryOp{}, size_t thread_count = 0) {
+		using value_type = typename Container::value_type;
+
+		scan_live<value_type>(container, std::nullopt, op, thread_count, [&](size_t, size_t index, const value_type& total) {
+			container[index] = total;
+		});
+	}
+
+	template<typename Container, typename Out, typename BinaryOp = std::plus<>>
+	void inclusive_scan(const Container& container, std::span<Out> out, BinaryOp op = BinaryOp{}, size_t thread_count = 0) {
+		if (out.size() < container.size()) {
+			throw std::length_error{ "inclusive_scan: output span is smaller than the live element count" };
+		}
+
+		scan_live<Out>(container, std::nullopt, op, thread_count, [&](size_t rank, size_t, const Out& total) {
+			out[rank] = total;
+		});
+	}
+
+	template<typename Container, typename T, typename BinaryOp = std::plus<>>
+		requires std::convertible_to<T, typename Container::value_type>
+	void exclusive_scan(Container& container, T init, BinaryOp op = BinaryOp{}, size_t thread_count = 0) {
+		using value_type = typename Container::value_type;
+
+		scan_live<value_type>(container, std::optional<value_type>{ std::move(init) }, op, thread_count, [&](size_t, size_t index, const value_type& total) {
+			container[index] = total;
+		});
+	}
+
+	template<typename Container, typename Out, typename T, typename BinaryOp = std::plus<>>
+	void exclusive_scan(const Container& container, std::span<Out> out, T init, BinaryOp op = BinaryOp{}, size_t thread_count = 0) {
+		if (out.size() < container.size()) {
+			throw std::length_error{ "exclusive_scan: output span is smaller than the live element count" };
+		}
+
+		scan_live<Out>(container, std::optional<Out>{ std::move(init) }, op, thread_count, [&](size_t rank, size_t, const Out& total) {
+			out[rank] = total;
+		});
+	}
+
+}
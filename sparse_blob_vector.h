@@ -0,0 +1,197 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+#include <cstring>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	inline static constexpr size_t _MIN_BLOB_CLASS{ 4 };
+	inline static constexpr size_t _BLOB_SLAB_SIZE{ 64 * 1024 };
+
+	class sparse_blob_vector {
+	private:
+		struct blob_ref {
+			uint64_t offset;
+			uint32_t length;
+			uint32_t size_class;
+		};
+
+		struct slab_pool {
+			size_t chunk_size{ 0 };
+			size_t slab_size{ 0 };
+			size_t used{ 0 };
+			size_t live{ 0 };
+			std::vector<std::unique_ptr<std::byte[]>> slabs{};
+			std::vector<uint64_t> free_chunks{};
+
+			std::byte* address(uint64_t offset) const {
+				return slabs[offset / slab_size].get() + offset % slab_size;
+			}
+		};
+
+		using ref_vector = sparse_vector<blob_ref>;
+
+	public:
+		using value_type = std::span<const std::byte>;
+
+	private:
+		ref_vector refs;
+		std::vector<slab_pool> pools;
+
+	public:
+		sparse_blob_vector(size_t initial_capacity = _BITSET_SIZE)
+			:refs{ initial_capacity } {
+		}
+
+		[[maybe_unused]] size_t push(std::span<const std::byte> blob) {
+			return refs.push(store(blob));
+		}
+
+		void insert(size_t index, std::span<const std::byte> blob) {
+			if (refs.test(index)) {
+				erase(index);
+			}
+
+			refs.insert(index, store(blob));
+		}
+
+		void erase(size_t index) {
+			const blob_ref& ref{ refs[index] };
+			slab_pool& pool{ pools[ref.size_class] };
+
+			pool.free_chunks.push_back(ref.offset);
+			--pool.live;
+
+			refs.erase(index);
+		}
+
+		std::span<const std::byte> at(size_t index) const {
+			const blob_ref& ref{ refs[index] };
+			return std::span<const std::byte>{ pools[ref.size_class].address(ref.offset), ref.length };
+		}
+
+		std::span<const std::byte> operator[](size_t index) const {
+			return at(index);
+		}
+
+		std::span<std::byte> data(size_t index) {
+			const blob_ref& ref{ refs[index] };
+			return std::span<std::byte>{ pools[ref.size_class].address(ref.offset), ref.length };
+		}
+
+		bool test(size_t index) const {
+			return refs.test(index);
+		}
+
+		size_t size() const {
+			return refs.size();
+		}
+
+		bool empty() const {
+			return refs.empty();
+		}
+
+		size_t capacity() const {
+			return refs.capacity();
+		}
+
+		size_t reserved_bytes() const {
+			size_t out{ 0 };
+			for (const slab_pool& pool : pools) {
+				out += pool.slabs.size() * pool.slab_size;
+			}
+			return out;
+		}
+
+		template<typename Fn>
+		void for_each(Fn&& fn) const {
+			for (auto it{ refs.begin() }; it != refs.end(); ++it) {
+				fn(it.index(), at(it.index()));
+			}
+		}
+
+		void clear() {
+			refs.clear();
+			pools.clear();
+		}
+
+		void compact() {
+			for (size_t size_class{ 0 }; size_class < pools.size(); ++size_class) {
+				slab_pool& pool{ pools[size_class] };
+
+				if (pool.free_chunks.empty()) {
+					continue;
+				}
+
+				slab_pool packed{ pool.chunk_size, pool.slab_size };
+
+				for (auto it{ refs.begin() }; it != refs.end(); ++it) {
+					blob_ref& ref{ *it };
+
+					if (ref.size_class != size_class) {
+						continue;
+					}
+
+					uint64_t offset{ allocate(packed) };
+					std::memcpy(packed.address(offset), pool.address(ref.offset), ref.length);
+					ref.offset = offset;
+				}
+
+				pool = std::move(packed);
+			}
+		}
+
+	private:
+		static size_t size_class_of(size_t length) {
+			size_t size_class{ static_cast<size_t>(std::bit_width(length > 1 ? length - 1 : 1)) };
+			return size_class < _MIN_BLOB_CLASS ? _MIN_BLOB_CLASS : size_class;
+		}
+
+		static uint64_t allocate(slab_pool& pool) {
+			++pool.live;
+
+			if (!pool.free_chunks.empty()) {
+				uint64_t offset{ pool.free_chunks.back() };
+				pool.free_chunks.pop_back();
+				return offset;
+			}
+
+			if (pool.slabs.empty() || pool.used + pool.chunk_size > pool.slab_size) {
+				pool.slabs.push_back(std::make_unique_for_overwrite<std::byte[]>(pool.slab_size));
+				pool.used = 0;
+			}
+
+			uint64_t offset{ (pool.slabs.size() - 1) * pool.slab_size + pool.used };
+			pool.used += pool.chunk_size;
+
+			return offset;
+		}
+
+		blob_ref store(std::span<const std::byte> blob) {
+			size_t size_class{ size_class_of(blob.size()) };
+
+			if (size_class >= pools.size()) {
+				pools.resize(size_class + 1);
+			}
+
+			slab_pool& pool{ pools[size_class] };
+
+			if (pool.chunk_size == 0) {
+				pool.chunk_size = size_t{ 1 } << size_class;
+				pool.slab_size = pool.chunk_size > _BLOB_SLAB_SIZE ? pool.chunk_size : _BLOB_SLAB_SIZE;
+			}
+
+			uint64_t offset{ allocate(pool) };
+
+			if (!blob.empty()) {
+				std::memcpy(pool.address(offset), blob.data(), blob.size());
+			}
+
+			return blob_ref{ offset, static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(size_class) };
+		}
+	};
+
+}
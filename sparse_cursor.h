@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	template<typename Container>
+	class sparse_cursor {
+	private:
+		using clock = std::chrono::steady_clock;
+
+	private:
+		Container* container;
+		size_t _block{ 0 };
+		size_t _bit{ 0 };
+
+	public:
+		sparse_cursor(Container& container, size_t index = 0)
+			:container{ &container } {
+			seek(index);
+		}
+
+		void seek(size_t index) {
+			_block = index / _BITSET_SIZE;
+			_bit = index % _BITSET_SIZE;
+		}
+
+		void rewind() {
+			seek(0);
+		}
+
+		size_t index() const {
+			return _block * _BITSET_SIZE + _bit;
+		}
+
+		size_t block() const {
+			return _block;
+		}
+
+		size_t bit() const {
+			return _bit;
+		}
+
+		bool done() const {
+			return container->find_next(index()) >= container->capacity();
+		}
+
+		template<typename Fn>
+		[[maybe_unused]] size_t advance_n(size_t count, Fn&& fn) {
+			size_t processed{ 0 };
+
+			for (; processed < count; ++processed) {
+				if (!step(fn)) {
+					break;
+				}
+			}
+
+			return processed;
+		}
+
+		template<typename Fn>
+		[[maybe_unused]] size_t advance_for(std::chrono::nanoseconds budget, Fn&& fn, size_t check_interval = 64) {
+			clock::time_point deadline{ clock::now() + budget };
+			size_t processed{ 0 };
+
+			check_interval = std::max(check_interval, size_t{ 1 });
+
+			for (;;) {
+				for (size_t count{ 0 }; count < check_interval; ++count, ++processed) {
+					if (!step(fn)) {
+						return processed;
+					}
+				}
+
+				if (clock::now() >= deadline) {
+					return processed;
+				}
+			}
+		}
+
+		template<typename Fn>
+		[[maybe_unused]] size_t advance_for(std::chrono::nanoseconds budget, size_t max_count, Fn&& fn, size_t check_interval = 64) {
+			clock::time_point deadline{ clock::now() + budget };
+			size_t processed{ 0 };
+
+			check_interval = std::max(check_interval, size_t{ 1 });
+
+			while (processed < max_count) {
+				size_t chunk{ std::min(check_interval, max_count - processed) };
+				size_t done_count{ advance_n(chunk, fn) };
+
+				processed += done_count;
+
+				if (done_count < chunk || clock::now() >= deadline) {
+					break;
+				}
+			}
+
+			return processed;
+		}
+
+	private:
+		template<typename Fn>
+		bool step(Fn& fn) {
+			size_t index{ container->find_next(this->index()) };
+
+			if (index >= container->capacity()) {
+				seek(index);
+				return false;
+			}
+
+			seek(index + 1);
+			fn(index, container->at(index));
+
+			return true;
+		}
+	};
+
+}
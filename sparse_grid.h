@@ -0,0 +1,343 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "sparse_map.h"
+
+namespace Byte {
+
+	template<size_t Dims>
+	struct morton {
+		static_assert(Dims == 2 || Dims == 3, "morton codes are defined for 2 and 3 dimensions");
+
+		using point = std::array<uint32_t, Dims>;
+
+		inline static constexpr size_t tile_shift{ Dims == 2 ? 3 : 2 };
+		inline static constexpr uint64_t axis_limit{ Dims == 2 ? uint64_t{ 1 } << 32 : uint64_t{ 1 } << 21 };
+
+		static uint64_t spread(uint64_t value) {
+			if constexpr (Dims == 2) {
+				value &= 0xFFFFFFFFULL;
+				value = (value | (value << 16)) & 0x0000FFFF0000FFFFULL;
+				value = (value | (value << 8)) & 0x00FF00FF00FF00FFULL;
+				value = (value | (value << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+				value = (value | (value << 2)) & 0x3333333333333333ULL;
+				value = (value | (value << 1)) & 0x5555555555555555ULL;
+			}
+			else {
+				value &= 0x1FFFFFULL;
+				value = (value | (value << 32)) & 0x001F00000000FFFFULL;
+				value = (value | (value << 16)) & 0x001F0000FF0000FFULL;
+				value = (value | (value << 8)) & 0x100F00F00F00F00FULL;
+				value = (value | (value << 4)) & 0x10C30C30C30C30C3ULL;
+				value = (value | (value << 2)) & 0x1249249249249249ULL;
+			}
+			return value;
+		}
+
+		static uint64_t compact(uint64_t value) {
+			if constexpr (Dims == 2) {
+				value &= 0x5555555555555555ULL;
+				value = (value | (value >> 1)) & 0x3333333333333333ULL;
+				value = (value | (value >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+				value = (value | (value >> 4)) & 0x00FF00FF00FF00FFULL;
+				value = (value | (value >> 8)) & 0x0000FFFF0000FFFFULL;
+				value = (value | (value >> 16)) & 0x00000000FFFFFFFFULL;
+			}
+			else {
+				value &= 0x1249249249249249ULL;
+				value = (value | (value >> 2)) & 0x10C30C30C30C30C3ULL;
+				value = (value | (value >> 4)) & 0x100F00F00F00F00FULL;
+				value = (value | (value >> 8)) & 0x001F0000FF0000FFULL;
+				value = (value | (value >> 16)) & 0x001F00000000FFFFULL;
+				value = (value | (value >> 32)) & 0x00000000001FFFFFULL;
+			}
+			return value;
+		}
+
+		static uint64_t encode(const point& position) {
+			uint64_t code{ 0 };
+			for (size_t axis{ 0 }; axis < Dims; ++axis) {
+				if (position[axis] >= axis_limit) {
+					throw std::out_of_range{ "morton: coordinate exceeds the per-axis limit" };
+				}
+				code |= spread(position[axis]) << axis;
+			}
+			return code;
+		}
+
+		static point decode(uint64_t code) {
+			point position;
+			for (size_t axis{ 0 }; axis < Dims; ++axis) {
+				position[axis] = static_cast<uint32_t>(compact(code >> axis));
+			}
+			return position;
+		}
+	};
+
+	template<typename T, size_t Dims = 2, typename Allocator = std::allocator<T>>
+	class sparse_grid {
+	private:
+		using morton_code = morton<Dims>;
+		using tile_map = sparse_map<uint64_t, uint32_t>;
+		using cell_vector = sparse_vector<T, Allocator>;
+
+	public:
+		using value_type = T;
+		using point = typename morton_code::point;
+
+		inline static constexpr size_t tile_width{ size_t{ 1 } << morton_code::tile_shift };
+
+	private:
+		tile_map tiles;
+		cell_vector cells;
+
+	public:
+		sparse_grid(size_t initial_tiles = 1)
+			:tiles{ initial_tiles }, cells{ initial_tiles * _BITSET_SIZE } {
+		}
+
+		void insert(const point& position, const T& value) {
+			insert(position, T{ value });
+		}
+
+		void insert(const point& position, T&& value) {
+			uint64_t code{ morton_code::encode(position) };
+			uint64_t tile{ code / _BITSET_SIZE };
+			size_t slot{ tiles.slot(tile) };
+
+			if (slot == tile_map::npos) {
+				tiles.insert(tile, 0);
+				slot = tiles.slot(tile);
+				cells.reserve((slot + 1) * _BITSET_SIZE);
+			}
+
+			size_t index{ slot * _BITSET_SIZE + code % _BITSET_SIZE };
+
+			if (cells.test(index)) {
+				cells[index] = std::move(value);
+				return;
+			}
+
+			cells.insert(index, std::move(value));
+			++*tiles.find(tile);
+		}
+
+		bool erase(const point& position) {
+			uint64_t code{ morton_code::encode(position) };
+			uint64_t tile{ code / _BITSET_SIZE };
+			size_t index{ cell_index(code) };
+
+			if (index == tile_map::npos || !cells.test(index)) {
+				return false;
+			}
+
+			cells.erase(index);
+
+			if (--*tiles.find(tile) == 0) {
+				tiles.erase(tile);
+			}
+
+			return true;
+		}
+
+		T* find(const point& position) {
+			size_t index{ cell_index(morton_code::encode(position)) };
+			return index != tile_map::npos && cells.test(index) ? &cells[index] : nullptr;
+		}
+
+		const T* find(const point& position) const {
+			size_t index{ cell_index(morton_code::encode(position)) };
+			return index != tile_map::npos && cells.test(index) ? &cells[index] : nullptr;
+		}
+
+		bool test(const point& position) const {
+			return find(position) != nullptr;
+		}
+
+		T& at(const point& position) {
+			return cells[cell_index(morton_code::encode(position))];
+		}
+
+		const T& at(const point& position) const {
+			return cells[cell_index(morton_code::encode(position))];
+		}
+
+		size_t size() const {
+			return cells.size();
+		}
+
+		bool empty() const {
+			return cells.empty();
+		}
+
+		size_t tile_count() const {
+			return tiles.size();
+		}
+
+		uint64_t tile_bits(const point& position) const {
+			size_t slot{ tiles.slot(morton_code::encode(position) / _BITSET_SIZE) };
+			return slot == tile_map::npos ? 0 : cells.block(slot).to_ullong();
+		}
+
+		template<typename Fn>
+		void for_each_tile(Fn&& fn) const {
+			for (auto it{ tiles.begin() }; it != tiles.end(); ++it) {
+				fn(morton_code::decode(it.key() * _BITSET_SIZE), cells.block(it.index()).to_ullong());
+			}
+		}
+
+		template<typename Fn>
+		void for_each(Fn&& fn) {
+			for (auto it{ tiles.begin() }; it != tiles.end(); ++it) {
+				visit_tile(it.key(), it.index(), std::numeric_limits<uint64_t>::max(), fn);
+			}
+		}
+
+		template<typename Fn>
+		void for_each_neighbor(const point& position, Fn&& fn) {
+			size_t count{ 1 };
+			for (size_t axis{ 0 }; axis < Dims; ++axis) {
+				count *= 3;
+			}
+
+			for (size_t offset{ 0 }; offset < count; ++offset) {
+				point neighbor{ position };
+				bool valid{ offset != count / 2 };
+
+				for (size_t axis{ 0 }, rest{ offset }; axis < Dims && valid; ++axis, rest /= 3) {
+					int64_t coordinate{ static_cast<int64_t>(position[axis]) + static_cast<int64_t>(rest % 3) - 1 };
+					valid = coordinate >= 0 && static_cast<uint64_t>(coordinate) < morton_code::axis_limit;
+					neighbor[axis] = static_cast<uint32_t>(coordinate);
+				}
+
+				if (T* value{ valid ? find(neighbor) : nullptr }) {
+					fn(neighbor, *value);
+				}
+			}
+		}
+
+		template<typename Fn>
+		void query(const point& low, const point& high, Fn&& fn) {
+			point tile_low;
+			point tile_high;
+			uint64_t box_tiles{ 1 };
+
+			for (size_t axis{ 0 }; axis < Dims; ++axis) {
+				if (low[axis] > high[axis] || low[axis] >= morton_code::axis_limit) {
+					return;
+				}
+
+				tile_low[axis] = low[axis] >> morton_code::tile_shift;
+				tile_high[axis] = static_cast<uint32_t>(std::min<uint64_t>(high[axis], morton_code::axis_limit - 1) >> morton_code::tile_shift);
+				box_tiles *= static_cast<uint64_t>(tile_high[axis] - tile_low[axis]) + 1;
+			}
+
+			auto visit{ [&](uint64_t tile, size_t slot) {
+				uint64_t bits{ cells.block(slot).to_ullong() };
+
+				for (; bits != 0; bits &= bits - 1) {
+					size_t bit{ static_cast<size_t>(std::countr_zero(bits)) };
+					point position{ morton_code::decode(tile * _BITSET_SIZE + bit) };
+
+					if (contains(low, high, position)) {
+						fn(position, cells[slot * _BITSET_SIZE + bit]);
+					}
+				}
+			} };
+
+			if (box_tiles > tiles.size()) {
+				for (auto it{ tiles.begin() }; it != tiles.end(); ++it) {
+					if (contains(tile_low, tile_high, morton_code::decode(it.key()))) {
+						visit(it.key(), it.index());
+					}
+				}
+				return;
+			}
+
+			point tile{ tile_low };
+			for (;;) {
+				uint64_t code{ morton_code::encode(tile) };
+				size_t slot{ tiles.slot(code) };
+
+				if (slot != tile_map::npos) {
+					visit(code, slot);
+				}
+
+				size_t axis{ 0 };
+				for (; axis < Dims; ++axis) {
+					if (tile[axis] < tile_high[axis]) {
+						++tile[axis];
+						break;
+					}
+					tile[axis] = tile_low[axis];
+				}
+
+				if (axis == Dims) {
+					break;
+				}
+			}
+		}
+
+		void compact() {
+			std::vector<std::pair<uint64_t, size_t>> order;
+			order.reserve(tiles.size());
+
+			for (auto it{ tiles.begin() }; it != tiles.end(); ++it) {
+				order.emplace_back(it.key(), it.index());
+			}
+
+			std::sort(order.begin(), order.end());
+
+			tile_map packed_tiles{ std::max<size_t>(order.size(), 1) };
+			cell_vector packed_cells{ std::max<size_t>(order.size(), 1) * _BITSET_SIZE };
+
+			for (const auto& [tile, slot] : order) {
+				uint64_t bits{ cells.block(slot).to_ullong() };
+
+				packed_tiles.insert(tile, static_cast<uint32_t>(std::popcount(bits)));
+				size_t packed_slot{ packed_tiles.slot(tile) };
+
+				for (; bits != 0; bits &= bits - 1) {
+					size_t bit{ static_cast<size_t>(std::countr_zero(bits)) };
+					packed_cells.insert(packed_slot * _BITSET_SIZE + bit, std::move(cells[slot * _BITSET_SIZE + bit]));
+				}
+			}
+
+			tiles = std::move(packed_tiles);
+			cells = std::move(packed_cells);
+		}
+
+		void clear() {
+			tiles.clear();
+			cells.clear();
+		}
+
+	private:
+		static bool contains(const point& low, const point& high, const point& position) {
+			for (size_t axis{ 0 }; axis < Dims; ++axis) {
+				if (position[axis] < low[axis] || position[axis] > high[axis]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		size_t cell_index(uint64_t code) const {
+			size_t slot{ tiles.slot(code / _BITSET_SIZE) };
+			return slot == tile_map::npos ? tile_map::npos : slot * _BITSET_SIZE + code % _BITSET_SIZE;
+		}
+
+		template<typename Fn>
+		void visit_tile(uint64_t tile, size_t slot, uint64_t mask, Fn& fn) {
+			for (uint64_t bits{ cells.block(slot).to_ullong() & mask }; bits != 0; bits &= bits - 1) {
+				size_t bit{ static_cast<size_t>(std::countr_zero(bits)) };
+				fn(morton_code::decode(tile * _BITSET_SIZE + bit), cells[slot * _BITSET_SIZE + bit]);
+			}
+		}
+	};
+
+}
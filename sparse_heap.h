@@ -0,0 +1,240 @@
+#pragma once
+
+#include <functional>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	inline static constexpr size_t _CACHE_LINE_SIZE{ 64 };
+
+	template<typename P, typename Compare = std::less<P>, size_t D = 4>
+	class indexed_heap {
+		static_assert(std::has_single_bit(D), "indexed_heap arity must be a power of two");
+
+	private:
+		struct entry {
+			P priority;
+			size_t index;
+		};
+
+		struct alignas(_CACHE_LINE_SIZE) entry_group {
+			entry entries[D];
+		};
+
+		inline static constexpr size_t _OFFSET{ D - 1 };
+
+	public:
+		using priority_type = P;
+
+		inline static constexpr size_t npos{ std::numeric_limits<size_t>::max() };
+
+	private:
+		std::vector<entry_group> groups;
+		std::vector<size_t> positions;
+		size_t _size{ 0 };
+		Compare compare;
+
+	public:
+		indexed_heap(size_t initial_capacity = _BITSET_SIZE, Compare compare = Compare{})
+			:compare{ std::move(compare) } {
+			reserve(initial_capacity);
+		}
+
+		void push(size_t index, const P& priority) {
+			if (contains(index)) {
+				update(index, priority);
+				return;
+			}
+
+			reserve(index + 1);
+
+			if (_size + _OFFSET >= groups.size() * D) {
+				groups.resize(groups.empty() ? 1 : 2 * groups.size());
+			}
+
+			node(_size) = entry{ priority, index };
+			positions[index] = _size;
+			sift_up(_size++);
+		}
+
+		void update(size_t index, const P& priority) {
+			size_t position{ positions[index] };
+			bool raised{ compare(priority, node(position).priority) };
+
+			node(position).priority = priority;
+
+			if (raised) {
+				sift_up(position);
+			}
+			else {
+				sift_down(position);
+			}
+		}
+
+		[[maybe_unused]] bool erase(size_t index) {
+			if (!contains(index)) {
+				return false;
+			}
+
+			size_t position{ positions[index] };
+			positions[index] = npos;
+
+			if (position != --_size) {
+				move(position, node(_size));
+
+				if (position > 0 && compare(node(position).priority, node(parent(position)).priority)) {
+					sift_up(position);
+				}
+				else {
+					sift_down(position);
+				}
+			}
+
+			return true;
+		}
+
+		size_t top() const {
+			return node(0).index;
+		}
+
+		const P& top_priority() const {
+			return node(0).priority;
+		}
+
+		[[maybe_unused]] size_t pop() {
+			size_t index{ top() };
+			erase(index);
+			return index;
+		}
+
+		const P& priority(size_t index) const {
+			return node(positions[index]).priority;
+		}
+
+		bool contains(size_t index) const {
+			return index < positions.size() && positions[index] != npos;
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		void reserve(size_t capacity) {
+			if (capacity > positions.size()) {
+				positions.resize(std::max(capacity, 2 * positions.size()), npos);
+			}
+		}
+
+		void clear() {
+			for (size_t position{ 0 }; position < _size; ++position) {
+				positions[node(position).index] = npos;
+			}
+			_size = 0;
+		}
+
+	private:
+		static size_t parent(size_t position) {
+			return (position - 1) / D;
+		}
+
+		entry& node(size_t position) {
+			size_t slot{ position + _OFFSET };
+			return groups[slot / D].entries[slot % D];
+		}
+
+		const entry& node(size_t position) const {
+			size_t slot{ position + _OFFSET };
+			return groups[slot / D].entries[slot % D];
+		}
+
+		void move(size_t position, entry value) {
+			positions[value.index] = position;
+			node(position) = std::move(value);
+		}
+
+		void sift_up(size_t position) {
+			entry value{ std::move(node(position)) };
+
+			while (position > 0) {
+				size_t _parent{ parent(position) };
+
+				if (!compare(value.priority, node(_parent).priority)) {
+					break;
+				}
+
+				move(position, std::move(node(_parent)));
+				position = _parent;
+			}
+
+			move(position, std::move(value));
+		}
+
+		void sift_down(size_t position) {
+			entry value{ std::move(node(position)) };
+
+			for (;;) {
+				size_t first{ D * position + 1 };
+
+				if (first >= _size) {
+					break;
+				}
+
+				size_t last{ std::min(first + D, _size) };
+				size_t best{ first };
+
+				for (size_t child{ first + 1 }; child < last; ++child) {
+					if (compare(node(child).priority, node(best).priority)) {
+						best = child;
+					}
+				}
+
+				if (!compare(node(best).priority, value.priority)) {
+					break;
+				}
+
+				move(position, std::move(node(best)));
+				position = best;
+			}
+
+			move(position, std::move(value));
+		}
+	};
+
+	template<typename Heap>
+	class heap_observer {
+	private:
+		Heap* heap;
+
+	public:
+		heap_observer() = delete;
+
+		heap_observer(Heap& heap)
+			:heap{ &heap } {
+		}
+
+		heap_observer(const heap_observer&) = delete;
+
+		heap_observer(heap_observer&&) = default;
+
+		heap_observer& operator=(const heap_observer&) = delete;
+
+		heap_observer& operator=(heap_observer&&) = default;
+
+		void on_insert(size_t) {
+		}
+
+		void on_erase(size_t index) {
+			heap->erase(index);
+		}
+
+		void on_grow(size_t, size_t new_capacity) {
+			heap->reserve(new_capacity);
+		}
+	};
+
+}
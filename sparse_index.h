@@ -0,0 +1,584 @@
+#pragma once
+
+#include <span>
+#include <bitset>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	template<typename T>
+	class secondary_index {
+	public:
+		virtual ~secondary_index() = default;
+
+		virtual void insert(size_t index, const T& value) = 0;
+
+		virtual void erase(size_t index, const T& value) = 0;
+
+		virtual void clear() = 0;
+
+		virtual void insert_batch(std::span<const size_t> indices, const T* data) {
+			for (size_t index : indices) {
+				insert(index, data[index]);
+			}
+		}
+
+		virtual void erase_batch(std::span<const size_t> indices, const T* data) {
+			for (size_t index : indices) {
+				erase(index, data[index]);
+			}
+		}
+	};
+
+	template<typename T, typename KeyFn, typename Hash = std::hash<std::decay_t<std::invoke_result_t<KeyFn&, const T&>>>>
+	class hash_index : public secondary_index<T> {
+	public:
+		using key_type = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>;
+
+	private:
+		using bucket = std::vector<size_t>;
+
+		KeyFn key_fn;
+		std::unordered_map<key_type, bucket, Hash> buckets;
+
+	public:
+		hash_index(KeyFn key_fn)
+			:key_fn{ std::move(key_fn) } {
+		}
+
+		void insert(size_t index, const T& value) override {
+			buckets[key_fn(value)].push_back(index);
+		}
+
+		void erase(size_t index, const T& value) override {
+			auto it{ buckets.find(key_fn(value)) };
+
+			if (it == buckets.end()) {
+				return;
+			}
+
+			bucket& _bucket{ it->second };
+
+			for (size_t& slot : _bucket) {
+				if (slot == index) {
+					slot = _bucket.back();
+					_bucket.pop_back();
+					break;
+				}
+			}
+
+			if (_bucket.empty()) {
+				buckets.erase(it);
+			}
+		}
+
+		void clear() override {
+			buckets.clear();
+		}
+
+		void insert_batch(std::span<const size_t> indices, const T* data) override {
+			buckets.reserve(buckets.size() + indices.size());
+
+			for (size_t index : indices) {
+				buckets[key_fn(data[index])].push_back(index);
+			}
+		}
+
+		std::span<const size_t> find(const key_type& key) const {
+			auto it{ buckets.find(key) };
+			return it == buckets.end() ? std::span<const size_t>{} : std::span<const size_t>{ it->second };
+		}
+
+		size_t count(const key_type& key) const {
+			return find(key).size();
+		}
+	};
+
+	template<typename T, typename KeyFn, typename Compare = std::less<>>
+	class sorted_index : public secondary_index<T> {
+	public:
+		using key_type = std::decay_t<std::invoke_result_t<KeyFn&, const T&>>;
+
+	private:
+		using entry_map = std::multimap<key_type, size_t, Compare>;
+
+		KeyFn key_fn;
+		entry_map entries;
+
+	public:
+		sorted_index(KeyFn key_fn, Compare compare = Compare{})
+			:key_fn{ std::move(key_fn) }, entries{ compare } {
+		}
+
+		void insert(size_t index, const T& value) override {
+			entries.emplace(key_fn(value), index);
+		}
+
+		void erase(size_t index, const T& value) override {
+			auto [it, _end] { entries.equal_range(key_fn(value)) };
+
+			for (; it != _end; ++it) {
+				if (it->second == index) {
+					entries.erase(it);
+					break;
+				}
+			}
+		}
+
+		void clear() override {
+			entries.clear();
+		}
+
+		void insert_batch(std::span<const size_t> indices, const T* data) override {
+			std::vector<std::pair<key_type, size_t>> batch;
+			batch.reserve(indices.size());
+
+			for (size_t index : indices) {
+				batch.emplace_back(key_fn(data[index]), index);
+			}
+
+			std::sort(batch.begin(), batch.end(), [&](const auto& left, const auto& right) {
+				return entries.key_comp()(left.first, right.first);
+			});
+
+			entries.insert(batch.begin(), batch.end());
+		}
+
+		std::vector<size_t> find(const key_type& key) const {
+			auto [it, _end] { entries.equal_range(key) };
+			return collect(it, _end);
+		}
+
+		std::vector<size_t> range(const key_type& low, const key_type& high) const {
+			return collect(entries.lower_bound(low), entries.lower_bound(high));
+		}
+
+		std::vector<size_t> ordered() const {
+			return collect(entries.begin(), entries.end());
+		}
+
+	private:
+		static std::vector<size_t> collect(typename entry_map::const_iterator it, typename entry_map::const_iterator _end) {
+			std::vector<size_t> out;
+			for (; it != _end; ++it) {
+				out.push_back(it->second);
+			}
+			return out;
+		}
+	};
+
+	template<typename T, typename Pred, typename Allocator = std::allocator<T>>
+	class sparse_view : public secondary_index<T> {
+	private:
+		using bitset64 = std::bitset<_BITSET_SIZE>;
+		using bitset_vector = std::vector<bitset64>;
+		using value_vector = sparse_vector<T, Allocator>;
+
+	public:
+		using value_type = T;
+		using const_iterator = sparse_vector_iterator<const T>;
+
+	private:
+		Pred pred;
+		const value_vector* values;
+		bitset_vector bitsets;
+		size_t _size{ 0 };
+
+	public:
+		sparse_view(Pred pred, const value_vector& values)
+			:pred{ std::move(pred) }, values{ &values }, bitsets(values.capacity() / _BITSET_SIZE) {
+		}
+
+		void insert(size_t index, const T& value) override {
+			if (!pred(value)) {
+				return;
+			}
+
+			size_t bitset_index{ index / _BITSET_SIZE };
+
+			if (bitset_index >= bitsets.size()) {
+				bitsets.resize(values->capacity() / _BITSET_SIZE);
+			}
+
+			bitsets[bitset_index].set(index % _BITSET_SIZE);
+			++_size;
+		}
+
+		void erase(size_t index, const T&) override {
+			if (test(index)) {
+				bitsets[index / _BITSET_SIZE].set(index % _BITSET_SIZE, false);
+				--_size;
+			}
+		}
+
+		void clear() override {
+			bitsets.assign(1, bitset64{});
+			_size = 0;
+		}
+
+		bool test(size_t index) const {
+			size_t bitset_index{ index / _BITSET_SIZE };
+			return bitset_index < bitsets.size() && bitsets[bitset_index].test(index % _BITSET_SIZE);
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		const_iterator begin() const {
+			return const_iterator{ values->data(), 0, &bitsets };
+		}
+
+		const_iterator end() const {
+			return const_iterator{ values->data(), bitsets.size() * _BITSET_SIZE, nullptr };
+		}
+	};
+
+	template<typename T, typename WeightFn>
+	class weighted_sampler : public secondary_index<T> {
+	private:
+		std::vector<double> tree;
+		size_t leaves{ 1 };
+		WeightFn weight_fn;
+
+	public:
+		weighted_sampler(WeightFn weight_fn, size_t capacity)
+			:weight_fn{ std::move(weight_fn) } {
+			reserve(capacity);
+		}
+
+		void insert(size_t index, const T& value) override {
+			double _weight{ static_cast<double>(weight_fn(value)) };
+
+			if (!(_weight >= 0.0)) {
+				throw std::invalid_argument{ "weighted_sampler: weights must be non-negative" };
+			}
+
+			reserve(index + 1);
+			update(index, _weight);
+		}
+
+		void erase(size_t index, const T&) override {
+			update(index, 0.0);
+		}
+
+		void clear() override {
+			std::fill(tree.begin(), tree.end(), 0.0);
+		}
+
+		double total() const {
+			return tree[1];
+		}
+
+		double weight(size_t index) const {
+			return index < leaves ? tree[leaves + index] : 0.0;
+		}
+
+		size_t capacity() const {
+			return leaves;
+		}
+
+		template<typename Rng>
+		size_t sample(Rng& rng) const {
+			if (!(total() > 0.0)) {
+				return leaves;
+			}
+
+			double target{ std::uniform_real_distribution<double>{ 0.0, total() }(rng) };
+			size_t node{ 1 };
+
+			while (node < leaves) {
+				double left{ tree[2 * node] };
+
+				if (target < left || tree[2 * node + 1] <= 0.0) {
+					node = 2 * node;
+				}
+				else {
+					target -= left;
+					node = 2 * node + 1;
+				}
+			}
+
+			return node - leaves;
+		}
+
+	private:
+		void reserve(size_t capacity) {
+			if (capacity <= leaves && !tree.empty()) {
+				return;
+			}
+
+			size_t new_leaves{ std::bit_ceil(capacity < 1 ? size_t{ 1 } : capacity) };
+			std::vector<double> new_tree(2 * new_leaves, 0.0);
+
+			for (size_t index{ 0 }; index < leaves && !tree.empty(); ++index) {
+				new_tree[new_leaves + index] = tree[leaves + index];
+			}
+
+			for (size_t node{ new_leaves - 1 }; node > 0; --node) {
+				new_tree[node] = new_tree[2 * node] + new_tree[2 * node + 1];
+			}
+
+			tree = std::move(new_tree);
+			leaves = new_leaves;
+		}
+
+		void update(size_t index, double value) {
+			size_t node{ leaves + index };
+			tree[node] = value;
+
+			for (node /= 2; node > 0; node /= 2) {
+				tree[node] = tree[2 * node] + tree[2 * node + 1];
+			}
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class indexed_sparse_vector {
+	private:
+		using value_vector = sparse_vector<T, Allocator>;
+		using index_pointer = std::unique_ptr<secondary_index<T>>;
+
+	public:
+		using value_type = T;
+		using const_reference = const T&;
+		using const_iterator = typename value_vector::const_iterator;
+
+	private:
+		value_vector _values;
+		std::vector<index_pointer> indexes;
+
+	public:
+		indexed_sparse_vector(size_t initial_capacity = _BITSET_SIZE)
+			:_values{ initial_capacity } {
+		}
+
+		indexed_sparse_vector(const indexed_sparse_vector&) = delete;
+
+		indexed_sparse_vector& operator=(const indexed_sparse_vector&) = delete;
+
+		template<typename KeyFn>
+		hash_index<T, KeyFn>& add_hash_index(KeyFn key_fn) {
+			return attach(std::make_unique<hash_index<T, KeyFn>>(std::move(key_fn)));
+		}
+
+		template<typename KeyFn, typename Compare = std::less<>>
+		sorted_index<T, KeyFn, Compare>& add_sorted_index(KeyFn key_fn, Compare compare = Compare{}) {
+			return attach(std::make_unique<sorted_index<T, KeyFn, Compare>>(std::move(key_fn), std::move(compare)));
+		}
+
+		template<typename Pred>
+		sparse_view<T, Pred, Allocator>& make_view(Pred pred) {
+			return attach(std::make_unique<sparse_view<T, Pred, Allocator>>(std::move(pred), _values));
+		}
+
+		template<typename WeightFn>
+		weighted_sampler<T, WeightFn>& make_weighted_sampler(WeightFn weight_fn) {
+			return attach(std::make_unique<weighted_sampler<T, WeightFn>>(std::move(weight_fn), _values.capacity()));
+		}
+
+		void remove_index(const secondary_index<T>& index) {
+			std::erase_if(indexes, [&](const index_pointer& _index) {
+				return _index.get() == &index;
+			});
+		}
+
+		template<typename Index, typename Key>
+		std::vector<size_t> find_by(const Index& index, const Key& key) const {
+			auto found{ index.find(key) };
+
+			if constexpr (std::is_same_v<decltype(found), std::vector<size_t>>) {
+				return found;
+			}
+			else {
+				return std::vector<size_t>(found.begin(), found.end());
+			}
+		}
+
+		[[maybe_unused]] size_t push(const T& value) {
+			return push(T{ value });
+		}
+
+		[[maybe_unused]] size_t push(T&& value) {
+			size_t index{ _values.push(std::move(value)) };
+			notify_insert(index);
+			return index;
+		}
+
+		template<class... Args>
+		[[maybe_unused]] size_t emplace(Args&&... args) {
+			size_t index{ _values.emplace(std::forward<Args>(args)...) };
+			notify_insert(index);
+			return index;
+		}
+
+		void insert(size_t index, const T& value) {
+			insert(index, T{ value });
+		}
+
+		void insert(size_t index, T&& value) {
+			if (_values.test(index)) {
+				modify(index, [&](T& current) {
+					current = std::move(value);
+				});
+				return;
+			}
+
+			_values.insert(index, std::move(value));
+			notify_insert(index);
+		}
+
+		void erase(size_t index) {
+			for (index_pointer& _index : indexes) {
+				_index->erase(index, _values[index]);
+			}
+
+			_values.erase(index);
+		}
+
+		template<typename Fn>
+		void modify(size_t index, Fn&& fn) {
+			T& value{ _values[index] };
+			T previous{ value };
+
+			for (index_pointer& _index : indexes) {
+				_index->erase(index, value);
+			}
+
+			try {
+				fn(value);
+				reindex(index);
+			}
+			catch (...) {
+				value = std::move(previous);
+				reindex(index);
+				throw;
+			}
+		}
+
+		template<typename Range>
+		std::vector<size_t> push_batch(Range&& range) {
+			std::vector<size_t> out;
+
+			for (auto&& value : range) {
+				out.push_back(_values.push(value));
+			}
+
+			for (index_pointer& _index : indexes) {
+				_index->insert_batch(out, _values.data());
+			}
+
+			return out;
+		}
+
+		void erase_batch(std::span<const size_t> batch) {
+			for (index_pointer& _index : indexes) {
+				_index->erase_batch(batch, _values.data());
+			}
+
+			for (size_t index : batch) {
+				_values.erase(index);
+			}
+		}
+
+		const_reference at(size_t index) const {
+			return _values.at(index);
+		}
+
+		const_reference operator[](size_t index) const {
+			return _values.at(index);
+		}
+
+		size_t size() const {
+			return _values.size();
+		}
+
+		bool empty() const {
+			return _values.empty();
+		}
+
+		size_t capacity() const {
+			return _values.capacity();
+		}
+
+		bool test(size_t index) const {
+			return _values.test(index);
+		}
+
+		void clear() {
+			_values.clear();
+
+			for (index_pointer& _index : indexes) {
+				_index->clear();
+			}
+		}
+
+		const_iterator begin() const {
+			return _values.begin();
+		}
+
+		const_iterator end() const {
+			return _values.end();
+		}
+
+		const value_vector& values() const {
+			return _values;
+		}
+
+	private:
+		template<typename Index>
+		Index& attach(std::unique_ptr<Index> index) {
+			Index& out{ *index };
+
+			std::vector<size_t> live;
+			live.reserve(_values.size());
+
+			for (auto it{ _values.begin() }; it != _values.end(); ++it) {
+				live.push_back(it.index());
+			}
+
+			out.insert_batch(live, _values.data());
+			indexes.push_back(std::move(index));
+
+			return out;
+		}
+
+		void notify_insert(size_t index) {
+			try {
+				reindex(index);
+			}
+			catch (...) {
+				_values.erase(index);
+				throw;
+			}
+		}
+
+		void reindex(size_t index) {
+			size_t notified{ 0 };
+
+			try {
+				for (; notified < indexes.size(); ++notified) {
+					indexes[notified]->insert(index, _values[index]);
+				}
+			}
+			catch (...) {
+				for (size_t _index{ 0 }; _index < notified; ++_index) {
+					indexes[_index]->erase(index, _values[index]);
+				}
+				throw;
+			}
+		}
+	};
+
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <stdexcept>
+#include <cstddef>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	class mapped_file {
+	private:
+		const std::byte* _data{ nullptr };
+		size_t _size{ 0 };
+
+#if !defined(__unix__) && !defined(__APPLE__)
+		std::vector<std::byte> buffer;
+#endif
+
+	public:
+		explicit mapped_file(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+			int descriptor{ ::open(path.c_str(), O_RDONLY) };
+			if (descriptor < 0) {
+				throw std::runtime_error{ "mapped_file: cannot open " + path };
+			}
+
+			struct stat status;
+			if (::fstat(descriptor, &status) != 0) {
+				::close(descriptor);
+				throw std::runtime_error{ "mapped_file: cannot stat " + path };
+			}
+
+			_size = static_cast<size_t>(status.st_size);
+
+			if (_size != 0) {
+				void* address{ ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0) };
+				if (address == MAP_FAILED) {
+					::close(descriptor);
+					throw std::runtime_error{ "mapped_file: cannot map " + path };
+				}
+
+				::madvise(address, _size, MADV_SEQUENTIAL);
+				_data = static_cast<const std::byte*>(address);
+			}
+
+			::close(descriptor);
+#else
+			std::ifstream file{ path, std::ios::binary | std::ios::ate };
+			if (!file) {
+				throw std::runtime_error{ "mapped_file: cannot open " + path };
+			}
+
+			buffer.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+			_data = buffer.data();
+			_size = buffer.size();
+#endif
+		}
+
+		mapped_file(const mapped_file&) = delete;
+
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		~mapped_file() {
+#if defined(__unix__) || defined(__APPLE__)
+			if (_data) {
+				::munmap(const_cast<std::byte*>(_data), _size);
+			}
+#endif
+		}
+
+		std::span<const std::byte> bytes() const {
+			return std::span<const std::byte>{ _data, _size };
+		}
+	};
+
+	struct load_options {
+		size_t thread_count{ 0 };
+		size_t segment_size{ 256 * 1024 * 1024 };
+	};
+
+	template<typename Container, typename ParseFn>
+	[[maybe_unused]] size_t load_binary(Container& container, const std::string& path, size_t record_size, ParseFn parse, load_options options = {}) {
+		using value_type = typename Container::value_type;
+		using batch_type = std::vector<std::pair<size_t, value_type>>;
+
+		if (record_size == 0) {
+			throw std::invalid_argument{ "load_binary: record_size must be non-zero" };
+		}
+
+		mapped_file file{ path };
+		std::span<const std::byte> bytes{ file.bytes() };
+
+		size_t thread_count{ options.thread_count == 0 ? default_thread_count() : options.thread_count };
+		size_t record_count{ bytes.size() / record_size };
+		size_t segment_records{ std::max(options.segment_size / record_size, size_t{ 1 }) };
+
+		for (size_t segment{ 0 }; segment < record_count; segment += segment_records) {
+			size_t segment_end{ std::min(segment + segment_records, record_count) };
+			std::vector<batch_type> batches(thread_count);
+
+			parallel_for(segment_end - segment, thread_count, [&](size_t thread_index, size_t begin, size_t end) {
+				batch_type& batch{ batches[thread_index] };
+				batch.reserve(end - begin);
+
+				for (size_t record{ segment + begin }; record < segment + end; ++record) {
+					batch.push_back(parse(bytes.subspan(record * record_size, record_size)));
+				}
+			});
+
+			container.insert_parallel(batches, thread_count);
+		}
+
+		return record_count;
+	}
+
+	template<typename Container, typename ParseFn>
+	[[maybe_unused]] size_t load_csv(Container& container, const std::string& path, ParseFn parse, load_options options = {}) {
+		using value_type = typename Container::value_type;
+		using batch_type = std::vector<std::pair<size_t, value_type>>;
+
+		mapped_file file{ path };
+		std::string_view text{ reinterpret_cast<const char*>(file.bytes().data()), file.bytes().size() };
+
+		size_t thread_count{ options.thread_count == 0 ? default_thread_count() : options.thread_count };
+		size_t loaded{ 0 };
+
+		auto boundary{ [&](size_t position) {
+			if (position >= text.size()) {
+				return text.size();
+			}
+
+			size_t line_end{ text.find('\n', position) };
+			return line_end == std::string_view::npos ? text.size() : line_end + 1;
+		} };
+
+		for (size_t segment{ 0 }; segment < text.size();) {
+			size_t segment_end{ boundary(segment + std::max(options.segment_size, size_t{ 1 }) - 1) };
+			std::vector<size_t> chunks(thread_count + 1, segment_end);
+			std::vector<batch_type> batches(thread_count);
+
+			chunks[0] = segment;
+			for (size_t chunk{ 1 }; chunk < thread_count; ++chunk) {
+				size_t position{ segment + (segment_end - segment) * chunk / thread_count };
+				chunks[chunk] = std::max(chunks[chunk - 1], position == segment ? segment : boundary(position - 1));
+			}
+
+			parallel_for(thread_count, thread_count, [&](size_t, size_t begin, size_t end) {
+				for (size_t chunk{ begin }; chunk < end; ++chunk) {
+					std::string_view lines{ text.substr(chunks[chunk], chunks[chunk + 1] - chunks[chunk]) };
+
+					while (!lines.empty()) {
+						size_t line_end{ lines.find('\n') };
+						std::string_view line{ lines.substr(0, line_end) };
+
+						lines.remove_prefix(line_end == std::string_view::npos ? lines.size() : line_end + 1);
+
+						if (!line.empty() && line.back() == '\r') {
+							line.remove_suffix(1);
+						}
+
+						if (std::optional<std::pair<size_t, value_type>> record{ parse(line) }) {
+							batches[chunk].push_back(std::move(*record));
+						}
+					}
+				}
+			});
+
+			for (const batch_type& batch : batches) {
+				loaded += batch.size();
+			}
+
+			container.insert_parallel(batches, thread_count);
+			segment = segment_end;
+		}
+
+		return loaded;
+	}
+
+}
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	inline static constexpr size_t _GROUP_SIZE{ 16 };
+
+	struct integer_hash {
+		size_t operator()(uint64_t key) const {
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdULL;
+			key ^= key >> 33;
+			key *= 0xc4ceb9fe1a85ec53ULL;
+			key ^= key >> 33;
+
+			return static_cast<size_t>(key);
+		}
+	};
+
+	template<typename K, typename T>
+	class sparse_map_iterator {
+	private:
+		using slot_iterator = sparse_vector_iterator<T>;
+		using key_type = const K;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<key_type&, T&>;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type;
+
+	private:
+		slot_iterator it;
+		key_type* keys;
+
+	public:
+		sparse_map_iterator(slot_iterator it, key_type* keys)
+			:it{ it }, keys{ keys } {
+		}
+
+		reference operator*() {
+			return reference{ keys[it.index()], *it };
+		}
+
+		sparse_map_iterator& operator++() {
+			++it;
+			return *this;
+		}
+
+		sparse_map_iterator operator++(int) {
+			sparse_map_iterator out{ *this };
+			++it;
+			return out;
+		}
+
+		bool operator==(const sparse_map_iterator& left) const {
+			return it == left.it;
+		}
+
+		bool operator!=(const sparse_map_iterator& left) const {
+			return it != left.it;
+		}
+
+		key_type& key() const {
+			return keys[it.index()];
+		}
+
+		T& value() {
+			return *it;
+		}
+
+		size_t index() const {
+			return it.index();
+		}
+	};
+
+	template<typename K, typename T, typename Hash = integer_hash, typename Allocator = std::allocator<T>>
+	class sparse_map {
+		static_assert(std::is_integral<K>::value, "sparse_map keys must be integers");
+
+	private:
+		using value_vector = sparse_vector<T, Allocator>;
+		using control_type = int8_t;
+
+		struct entry {
+			K key;
+			size_t slot;
+		};
+
+		inline static constexpr control_type _EMPTY{ -128 };
+		inline static constexpr control_type _DELETED{ -2 };
+
+	public:
+		using key_type = K;
+		using mapped_type = T;
+		using iterator = sparse_map_iterator<K, T>;
+		using const_iterator = sparse_map_iterator<K, const T>;
+
+		inline static constexpr size_t npos{ std::numeric_limits<size_t>::max() };
+
+	private:
+		value_vector values;
+		std::vector<K> keys;
+		std::vector<control_type> controls;
+		std::vector<entry> entries;
+		size_t _growth_left{ 0 };
+		Hash hasher;
+
+	public:
+		sparse_map(size_t initial_capacity = _BITSET_SIZE)
+			:values{ initial_capacity } {
+			keys.resize(values.capacity());
+			rehash(table_capacity(initial_capacity));
+		}
+
+		template<class... Args>
+		bool emplace(K key, Args&&... args) {
+			size_t hash{ hasher(static_cast<uint64_t>(key)) };
+
+			if (find_entry(key, hash) != npos) {
+				return false;
+			}
+
+			if (_growth_left == 0) {
+				rehash(2 * (values.size() + 1) > controls.size() - controls.size() / 8 ? 2 * controls.size() : controls.size());
+			}
+
+			size_t slot{ values.emplace(std::forward<Args>(args)...) };
+
+			if (slot >= keys.size()) {
+				keys.resize(values.capacity());
+			}
+			keys[slot] = key;
+
+			insert_entry(key, hash, slot);
+
+			return true;
+		}
+
+		bool insert(K key, const T& value) {
+			return emplace(key, T{ value });
+		}
+
+		bool insert(K key, T&& value) {
+			return emplace(key, std::move(value));
+		}
+
+		bool erase(K key) {
+			size_t position{ find_entry(key, hasher(static_cast<uint64_t>(key))) };
+
+			if (position == npos) {
+				return false;
+			}
+
+			values.erase(entries[position].slot);
+			controls[position] = _DELETED;
+
+			return true;
+		}
+
+		T* find(K key) {
+			size_t _slot{ slot(key) };
+			return _slot == npos ? nullptr : &values[_slot];
+		}
+
+		const T* find(K key) const {
+			size_t _slot{ slot(key) };
+			return _slot == npos ? nullptr : &values[_slot];
+		}
+
+		size_t slot(K key) const {
+			size_t position{ find_entry(key, hasher(static_cast<uint64_t>(key))) };
+			return position == npos ? npos : entries[position].slot;
+		}
+
+		bool contains(K key) const {
+			return slot(key) != npos;
+		}
+
+		T& at(K key) {
+			T* out{ find(key) };
+			if (!out) {
+				throw std::out_of_range{ "sparse_map::at" };
+			}
+			return *out;
+		}
+
+		const T& at(K key) const {
+			const T* out{ find(key) };
+			if (!out) {
+				throw std::out_of_range{ "sparse_map::at" };
+			}
+			return *out;
+		}
+
+		T& operator[](K key) {
+			T* out{ find(key) };
+			if (!out) {
+				emplace(key);
+				out = find(key);
+			}
+			return *out;
+		}
+
+		size_t size() const {
+			return values.size();
+		}
+
+		bool empty() const {
+			return values.empty();
+		}
+
+		void reserve(size_t count) {
+			size_t capacity{ table_capacity(count) };
+			if (capacity > controls.size()) {
+				rehash(capacity);
+			}
+		}
+
+		void clear() {
+			values.clear();
+			keys.resize(values.capacity());
+			rehash(_GROUP_SIZE);
+		}
+
+		iterator begin() {
+			return iterator{ values.begin(), keys.data() };
+		}
+
+		iterator end() {
+			return iterator{ values.end(), keys.data() };
+		}
+
+		const_iterator begin() const {
+			return const_iterator{ values.begin(), keys.data() };
+		}
+
+		const_iterator end() const {
+			return const_iterator{ values.end(), keys.data() };
+		}
+
+		const value_vector& slots() const {
+			return values;
+		}
+
+	private:
+		static size_t table_capacity(size_t count) {
+			size_t capacity{ std::bit_ceil(count + count / 7 + 1) };
+			return capacity < _GROUP_SIZE ? _GROUP_SIZE : capacity;
+		}
+
+		static uint32_t match(const control_type* group, control_type value) {
+#if defined(__SSE2__)
+			__m128i _group{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(group)) };
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), _group)));
+#else
+			uint32_t mask{ 0 };
+			for (size_t index{ 0 }; index < _GROUP_SIZE; ++index) {
+				mask |= static_cast<uint32_t>(group[index] == value) << index;
+			}
+			return mask;
+#endif
+		}
+
+		static uint32_t match_free(const control_type* group) {
+#if defined(__SSE2__)
+			__m128i _group{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(group)) };
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _group)));
+#else
+			uint32_t mask{ 0 };
+			for (size_t index{ 0 }; index < _GROUP_SIZE; ++index) {
+				mask |= static_cast<uint32_t>(group[index] < -1) << index;
+			}
+			return mask;
+#endif
+		}
+
+		size_t find_entry(K key, size_t hash) const {
+			size_t group_mask{ controls.size() / _GROUP_SIZE - 1 };
+			size_t group{ (hash >> 7) & group_mask };
+			control_type tag{ static_cast<control_type>(hash & 0x7F) };
+
+			for (size_t step{ 1 };; ++step) {
+				const control_type* _group{ controls.data() + group * _GROUP_SIZE };
+
+				for (uint32_t mask{ match(_group, tag) }; mask != 0; mask &= mask - 1) {
+					size_t position{ group * _GROUP_SIZE + std::countr_zero(mask) };
+					if (entries[position].key == key) {
+						return position;
+					}
+				}
+
+				if (match(_group, _EMPTY) != 0) {
+					return npos;
+				}
+
+				group = (group + step) & group_mask;
+			}
+		}
+
+		size_t find_free(size_t hash) const {
+			size_t group_mask{ controls.size() / _GROUP_SIZE - 1 };
+			size_t group{ (hash >> 7) & group_mask };
+
+			for (size_t step{ 1 };; ++step) {
+				uint32_t mask{ match_free(controls.data() + group * _GROUP_SIZE) };
+
+				if (mask != 0) {
+					return group * _GROUP_SIZE + std::countr_zero(mask);
+				}
+
+				group = (group + step) & group_mask;
+			}
+		}
+
+		void insert_entry(K key, size_t hash, size_t slot) {
+			size_t position{ find_free(hash) };
+
+			if (controls[position] == _EMPTY) {
+				--_growth_left;
+			}
+
+			controls[position] = static_cast<control_type>(hash & 0x7F);
+			entries[position] = entry{ key, slot };
+		}
+
+		void rehash(size_t new_capacity) {
+			controls.assign(new_capacity, _EMPTY);
+			entries.resize(new_capacity);
+			_growth_left = new_capacity - new_capacity / 8;
+
+			for (auto it{ values.begin() }; it != values.end(); ++it) {
+				K key{ keys[it.index()] };
+				size_t hash{ hasher(static_cast<uint64_t>(key)) };
+				size_t position{ find_free(hash) };
+
+				controls[position] = static_cast<control_type>(hash & 0x7F);
+				entries[position] = entry{ key, it.index() };
+				--_growth_left;
+			}
+		}
+	};
+
+}
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <stdexcept>
+#include <shared_mutex>
+#include <condition_variable>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	template<typename T>
+	struct mvcc_version {
+		std::optional<T> value;
+		uint64_t commit;
+		size_t next;
+	};
+
+	template<typename T, typename Allocator>
+	class mvcc_sparse_vector;
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class mvcc_read_view {
+	private:
+		using container_type = mvcc_sparse_vector<T, Allocator>;
+
+	private:
+		const container_type* container{ nullptr };
+		uint64_t _timestamp{ 0 };
+
+	public:
+		mvcc_read_view() = default;
+
+		mvcc_read_view(const container_type& container, uint64_t timestamp)
+			:container{ &container }, _timestamp{ timestamp } {
+		}
+
+		mvcc_read_view(const mvcc_read_view&) = delete;
+
+		mvcc_read_view(mvcc_read_view&& right) noexcept
+			:container{ right.container }, _timestamp{ right._timestamp } {
+			right.container = nullptr;
+		}
+
+		~mvcc_read_view() {
+			close();
+		}
+
+		mvcc_read_view& operator=(const mvcc_read_view&) = delete;
+
+		mvcc_read_view& operator=(mvcc_read_view&& right) noexcept {
+			if (this != &right) {
+				close();
+				std::swap(container, right.container);
+				std::swap(_timestamp, right._timestamp);
+			}
+			return *this;
+		}
+
+		uint64_t timestamp() const {
+			return _timestamp;
+		}
+
+		bool contains(size_t index) const {
+			return container->read(index, _timestamp, [](const T&) {});
+		}
+
+		std::optional<T> get(size_t index) const {
+			std::optional<T> out;
+			container->read(index, _timestamp, [&](const T& value) {
+				out = value;
+			});
+			return out;
+		}
+
+		template<typename Fn>
+		bool read(size_t index, Fn&& fn) const {
+			return container->read(index, _timestamp, fn);
+		}
+
+		template<typename Fn>
+		void for_each(Fn&& fn) const {
+			container->for_each(_timestamp, fn);
+		}
+
+		void close() {
+			if (container) {
+				container->close_view(_timestamp);
+				container = nullptr;
+			}
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class mvcc_sparse_vector {
+	private:
+		using version_type = mvcc_version<T>;
+		using version_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<version_type>;
+		using head_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+
+		inline static constexpr size_t npos{ std::numeric_limits<size_t>::max() };
+
+		friend class mvcc_read_view<T, Allocator>;
+
+	public:
+		using value_type = T;
+		using read_view = mvcc_read_view<T, Allocator>;
+
+		class write_transaction {
+		private:
+			mvcc_sparse_vector* container;
+			std::vector<std::pair<size_t, std::optional<T>>> writes;
+
+		public:
+			explicit write_transaction(mvcc_sparse_vector& container)
+				:container{ &container } {
+			}
+
+			void update(size_t index, T value) {
+				writes.emplace_back(index, std::move(value));
+			}
+
+			void erase(size_t index) {
+				writes.emplace_back(index, std::nullopt);
+			}
+
+			size_t size() const {
+				return writes.size();
+			}
+
+			uint64_t commit() {
+				uint64_t out{ container->apply(writes) };
+				writes.clear();
+				return out;
+			}
+		};
+
+	private:
+		sparse_vector<version_type, version_allocator> versions;
+		sparse_vector<size_t, head_allocator> heads;
+		std::atomic<uint64_t> clock{ 0 };
+		uint64_t collected{ 0 };
+		mutable std::shared_mutex mutex;
+		mutable std::mutex views_mutex;
+		mutable std::multiset<uint64_t> views;
+
+		std::thread collector;
+		std::mutex collector_mutex;
+		std::condition_variable collector_signal;
+		bool collector_stop{ false };
+
+	public:
+		mvcc_sparse_vector(size_t initial_capacity = _BITSET_SIZE)
+			:versions{ initial_capacity }, heads{ initial_capacity } {
+		}
+
+		mvcc_sparse_vector(const mvcc_sparse_vector&) = delete;
+
+		mvcc_sparse_vector& operator=(const mvcc_sparse_vector&) = delete;
+
+		~mvcc_sparse_vector() {
+			stop_collector();
+		}
+
+		[[maybe_unused]] size_t push(T value) {
+			std::unique_lock lock{ mutex };
+
+			uint64_t timestamp{ clock.load() + 1 };
+			size_t index{ heads.push(versions.push(version_type{ std::move(value), timestamp, npos })) };
+
+			clock.store(timestamp);
+			return index;
+		}
+
+		uint64_t update(size_t index, T value) {
+			write_transaction transaction{ *this };
+			transaction.update(index, std::move(value));
+			return transaction.commit();
+		}
+
+		uint64_t erase(size_t index) {
+			write_transaction transaction{ *this };
+			transaction.erase(index);
+			return transaction.commit();
+		}
+
+		write_transaction begin_write() {
+			return write_transaction{ *this };
+		}
+
+		uint64_t timestamp() const {
+			return clock.load();
+		}
+
+		read_view open_view() const {
+			std::lock_guard lock{ views_mutex };
+			uint64_t timestamp{ clock.load() };
+			views.insert(timestamp);
+			return read_view{ *this, timestamp };
+		}
+
+		read_view open_view(uint64_t timestamp) const {
+			std::lock_guard lock{ views_mutex };
+
+			if (timestamp < collected) {
+				throw std::out_of_range{ "mvcc_sparse_vector: versions before the requested timestamp were collected" };
+			}
+
+			timestamp = std::min(timestamp, clock.load());
+			views.insert(timestamp);
+			return read_view{ *this, timestamp };
+		}
+
+		size_t version_count() const {
+			std::shared_lock lock{ mutex };
+			return versions.size();
+		}
+
+		size_t slot_count() const {
+			std::shared_lock lock{ mutex };
+			return heads.size();
+		}
+
+		[[maybe_unused]] size_t collect() {
+			uint64_t watermark;
+			{
+				std::lock_guard lock{ views_mutex };
+				watermark = views.empty() ? clock.load() : std::min(*views.begin(), clock.load());
+				collected = std::max(collected, watermark);
+			}
+
+			std::unique_lock lock{ mutex };
+			size_t released{ 0 };
+
+			for (size_t bitset_index{ 0 }; bitset_index < heads.block_count(); ++bitset_index) {
+				for (uint64_t _bitset{ heads.block(bitset_index).to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+					size_t index{ bitset_index * _BITSET_SIZE + std::countr_zero(_bitset) };
+					size_t visible{ heads[index] };
+
+					while (visible != npos && versions[visible].commit > watermark) {
+						visible = versions[visible].next;
+					}
+
+					if (visible == npos) {
+						continue;
+					}
+
+					for (size_t version{ versions[visible].next }; version != npos;) {
+						size_t next{ versions[version].next };
+						versions.erase(version);
+						version = next;
+						++released;
+					}
+
+					versions[visible].next = npos;
+
+					if (!versions[visible].value && heads[index] == visible) {
+						versions.erase(visible);
+						heads.erase(index);
+						++released;
+					}
+				}
+			}
+
+			return released;
+		}
+
+		template<class Rep, class Period>
+		void start_collector(std::chrono::duration<Rep, Period> interval) {
+			stop_collector();
+
+			collector_stop = false;
+			collector = std::thread{ [this, interval] {
+				std::unique_lock lock{ collector_mutex };
+
+				while (!collector_signal.wait_for(lock, interval, [this] { return collector_stop; })) {
+					lock.unlock();
+					collect();
+					lock.lock();
+				}
+			} };
+		}
+
+		void stop_collector() {
+			if (!collector.joinable()) {
+				return;
+			}
+
+			{
+				std::lock_guard lock{ collector_mutex };
+				collector_stop = true;
+			}
+
+			collector_signal.notify_all();
+			collector.join();
+		}
+
+	private:
+		uint64_t apply(std::vector<std::pair<size_t, std::optional<T>>>& writes) {
+			std::unique_lock lock{ mutex };
+
+			for (const auto& [index, value] : writes) {
+				if (index >= heads.capacity() || !heads.test(index) || !versions[heads[index]].value) {
+					throw std::out_of_range{ "mvcc_sparse_vector: write to a slot that is not live" };
+				}
+			}
+
+			uint64_t timestamp{ clock.load() + 1 };
+
+			for (auto& [index, value] : writes) {
+				heads[index] = versions.push(version_type{ std::move(value), timestamp, heads[index] });
+			}
+
+			clock.store(timestamp);
+			return timestamp;
+		}
+
+		void close_view(uint64_t timestamp) const {
+			std::lock_guard lock{ views_mutex };
+			views.erase(views.find(timestamp));
+		}
+
+		const version_type* visible(size_t index, uint64_t timestamp) const {
+			if (index >= heads.capacity() || !heads.test(index)) {
+				return nullptr;
+			}
+
+			size_t version{ heads[index] };
+			while (version != npos && versions[version].commit > timestamp) {
+				version = versions[version].next;
+			}
+
+			return version == npos || !versions[version].value ? nullptr : &versions[version];
+		}
+
+		template<typename Fn>
+		bool read(size_t index, uint64_t timestamp, Fn&& fn) const {
+			std::shared_lock lock{ mutex };
+
+			const version_type* version{ visible(index, timestamp) };
+			if (version) {
+				fn(*version->value);
+			}
+
+			return version != nullptr;
+		}
+
+		template<typename Fn>
+		void for_each(uint64_t timestamp, Fn&& fn) const {
+			std::shared_lock lock{ mutex };
+
+			for (size_t bitset_index{ 0 }; bitset_index < heads.block_count(); ++bitset_index) {
+				for (uint64_t _bitset{ heads.block(bitset_index).to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+					size_t index{ bitset_index * _BITSET_SIZE + std::countr_zero(_bitset) };
+
+					if (const version_type* version{ visible(index, timestamp) }) {
+						fn(index, *version->value);
+					}
+				}
+			}
+		}
+	};
+
+}
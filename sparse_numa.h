@@ -0,0 +1,399 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <fstream>
+#include <optional>
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	struct numa_node {
+		size_t id{ 0 };
+		std::vector<size_t> cpus{};
+	};
+
+	class numa_topology {
+	private:
+		std::vector<numa_node> nodes;
+		std::vector<size_t> cpu_nodes;
+
+	public:
+		static numa_topology single() {
+			numa_topology out;
+			numa_node node{ 0 };
+
+			for (size_t cpu{ 0 }; cpu < default_thread_count(); ++cpu) {
+				node.cpus.push_back(cpu);
+			}
+
+			out.add(std::move(node));
+			return out;
+		}
+
+		static numa_topology detect() {
+#if defined(__linux__)
+			numa_topology out;
+			cpu_set_t allowed;
+
+			CPU_ZERO(&allowed);
+			bool restricted{ ::sched_getaffinity(0, sizeof(allowed), &allowed) == 0 };
+
+			std::ifstream online{ "/sys/devices/system/node/online" };
+			std::string line;
+
+			if (online && std::getline(online, line)) {
+				for (size_t id : parse_list(line)) {
+					std::ifstream cpulist{ "/sys/devices/system/node/node" + std::to_string(id) + "/cpulist" };
+					numa_node node{ id };
+
+					if (cpulist && std::getline(cpulist, line)) {
+						for (size_t cpu : parse_list(line)) {
+							if (!restricted || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) {
+								node.cpus.push_back(cpu);
+							}
+						}
+					}
+
+					if (!node.cpus.empty()) {
+						out.add(std::move(node));
+					}
+				}
+			}
+
+			if (out.node_count() != 0) {
+				return out;
+			}
+#endif
+			return single();
+		}
+
+		size_t node_count() const {
+			return nodes.size();
+		}
+
+		const numa_node& node(size_t node_index) const {
+			return nodes[node_index];
+		}
+
+		size_t node_of_cpu(size_t cpu) const {
+			return cpu < cpu_nodes.size() ? cpu_nodes[cpu] : 0;
+		}
+
+		size_t current_node() const {
+#if defined(__linux__)
+			int cpu{ ::sched_getcpu() };
+			if (cpu >= 0) {
+				return node_of_cpu(static_cast<size_t>(cpu));
+			}
+#endif
+			return 0;
+		}
+
+		void pin(size_t node_index) const {
+#if defined(__linux__)
+			if (nodes.size() <= 1) {
+				return;
+			}
+
+			cpu_set_t set;
+			CPU_ZERO(&set);
+
+			for (size_t cpu : nodes[node_index].cpus) {
+				if (cpu < CPU_SETSIZE) {
+					CPU_SET(cpu, &set);
+				}
+			}
+
+			::sched_setaffinity(0, sizeof(set), &set);
+#else
+			(void)node_index;
+#endif
+		}
+
+		bool bind(void* data, size_t bytes, size_t node_index) const {
+#if defined(__linux__) && defined(SYS_mbind)
+			constexpr int _MPOL_BIND{ 2 };
+			constexpr unsigned _MPOL_MF_MOVE{ 1 << 1 };
+			constexpr size_t _MASK_BITS{ 8 * sizeof(unsigned long) };
+
+			if (nodes.size() <= 1 || bytes == 0) {
+				return false;
+			}
+
+			uintptr_t page{ page_size() };
+			uintptr_t begin{ (reinterpret_cast<uintptr_t>(data) + page - 1) & ~(page - 1) };
+			uintptr_t end{ (reinterpret_cast<uintptr_t>(data) + bytes) & ~(page - 1) };
+
+			if (end <= begin) {
+				return false;
+			}
+
+			size_t id{ nodes[node_index].id };
+			std::vector<unsigned long> mask(id / _MASK_BITS + 1, 0);
+			mask[id / _MASK_BITS] |= 1UL << (id % _MASK_BITS);
+
+			return ::syscall(SYS_mbind, begin, end - begin, _MPOL_BIND, mask.data(), mask.size() * _MASK_BITS + 1, _MPOL_MF_MOVE) == 0;
+#else
+			(void)data;
+			(void)bytes;
+			(void)node_index;
+			return false;
+#endif
+		}
+
+		static size_t page_size() {
+#if defined(__linux__)
+			long page{ ::sysconf(_SC_PAGESIZE) };
+			if (page > 0) {
+				return static_cast<size_t>(page);
+			}
+#endif
+			return 4096;
+		}
+
+		template<typename Fn>
+		void for_each_node(Fn&& fn) const {
+#if defined(__linux__)
+			cpu_set_t affinity;
+			bool restore{ nodes.size() > 1 && ::sched_getaffinity(0, sizeof(affinity), &affinity) == 0 };
+#endif
+
+			parallel_for(nodes.size(), nodes.size(), [&](size_t, size_t begin, size_t end) {
+				for (size_t node_index{ begin }; node_index < end; ++node_index) {
+					pin(node_index);
+					fn(node_index);
+				}
+			});
+
+#if defined(__linux__)
+			if (restore) {
+				::sched_setaffinity(0, sizeof(affinity), &affinity);
+			}
+#endif
+		}
+
+	private:
+		void add(numa_node node) {
+			for (size_t cpu : node.cpus) {
+				if (cpu >= cpu_nodes.size()) {
+					cpu_nodes.resize(cpu + 1, 0);
+				}
+				cpu_nodes[cpu] = nodes.size();
+			}
+			nodes.push_back(std::move(node));
+		}
+
+		static std::vector<size_t> parse_list(const std::string& text) {
+			std::vector<size_t> out;
+
+			for (size_t position{ 0 }; position < text.size();) {
+				size_t comma{ std::min(text.find(',', position), text.size()) };
+				std::string range{ text.substr(position, comma - position) };
+				size_t dash{ range.find('-') };
+
+				if (!range.empty() && range.find_first_not_of("0123456789-\n ") == std::string::npos) {
+					size_t first{ std::stoull(range) };
+					size_t last{ dash == std::string::npos ? first : std::stoull(range.substr(dash + 1)) };
+
+					for (size_t value{ first }; value <= last; ++value) {
+						out.push_back(value);
+					}
+				}
+
+				position = comma + 1;
+			}
+
+			return out;
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class numa_sparse_vector {
+	private:
+		using shard_type = sparse_vector<T, Allocator>;
+
+	public:
+		using value_type = T;
+		using reference = T&;
+		using const_reference = const T&;
+
+	private:
+		numa_topology topology;
+		std::vector<shard_type> shards;
+		size_t _region_capacity;
+		size_t _size{ 0 };
+
+	public:
+		numa_sparse_vector(size_t region_capacity, numa_topology topology = numa_topology::detect())
+			:topology{ std::move(topology) },
+			_region_capacity{ region_capacity + (_BITSET_SIZE - region_capacity % _BITSET_SIZE) % _BITSET_SIZE } {
+			size_t node_count{ this->topology.node_count() };
+			std::vector<std::optional<shard_type>> placed(node_count);
+
+			this->topology.for_each_node([&](size_t node_index) {
+				placed[node_index].emplace(_region_capacity);
+				place(*placed[node_index], node_index);
+			});
+
+			shards.reserve(node_count);
+			for (std::optional<shard_type>& shard : placed) {
+				shards.push_back(std::move(*shard));
+			}
+		}
+
+		numa_sparse_vector(const numa_sparse_vector&) = delete;
+
+		numa_sparse_vector& operator=(const numa_sparse_vector&) = delete;
+
+		[[maybe_unused]] size_t push(const T& value) {
+			return push_on(topology.current_node(), T{ value });
+		}
+
+		[[maybe_unused]] size_t push(T&& value) {
+			return push_on(topology.current_node(), std::move(value));
+		}
+
+		[[maybe_unused]] size_t push_on(size_t node_index, T&& value) {
+			for (size_t attempt{ 0 }; attempt < shards.size(); ++attempt) {
+				size_t shard_index{ (node_index + attempt) % shards.size() };
+
+				if (shards[shard_index].size() < _region_capacity) {
+					size_t local{ shards[shard_index].push(std::move(value)) };
+					++_size;
+					return shard_index * _region_capacity + local;
+				}
+			}
+
+			throw std::length_error{ "numa_sparse_vector: all regions are full" };
+		}
+
+		void insert(size_t index, const T& value) {
+			insert(index, T{ value });
+		}
+
+		void insert(size_t index, T&& value) {
+			check(index);
+			shards[index / _region_capacity].insert(index % _region_capacity, std::move(value));
+			++_size;
+		}
+
+		void erase(size_t index) {
+			shards[index / _region_capacity].erase(index % _region_capacity);
+			--_size;
+		}
+
+		bool test(size_t index) const {
+			return index < capacity() && shards[index / _region_capacity].test(index % _region_capacity);
+		}
+
+		reference operator[](size_t index) {
+			return shards[index / _region_capacity][index % _region_capacity];
+		}
+
+		const_reference operator[](size_t index) const {
+			return shards[index / _region_capacity][index % _region_capacity];
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		size_t capacity() const {
+			return _region_capacity * shards.size();
+		}
+
+		size_t region_capacity() const {
+			return _region_capacity;
+		}
+
+		size_t node_count() const {
+			return shards.size();
+		}
+
+		size_t node_of(size_t index) const {
+			return index / _region_capacity;
+		}
+
+		shard_type& region(size_t node_index) {
+			return shards[node_index];
+		}
+
+		const shard_type& region(size_t node_index) const {
+			return shards[node_index];
+		}
+
+		const numa_topology& nodes() const {
+			return topology;
+		}
+
+		template<typename Fn>
+		void for_each(Fn&& fn) {
+			for (size_t node_index{ 0 }; node_index < shards.size(); ++node_index) {
+				visit(node_index, 0, shards[node_index].block_count(), fn);
+			}
+		}
+
+		template<typename Fn>
+		void parallel_for_each(Fn&& fn, size_t threads_per_node = 0) {
+			topology.for_each_node([&](size_t node_index) {
+				size_t thread_count{ threads_per_node == 0 ? topology.node(node_index).cpus.size() : threads_per_node };
+
+				parallel_for(shards[node_index].block_count(), thread_count, [&](size_t, size_t begin, size_t end) {
+					topology.pin(node_index);
+					visit(node_index, begin, end, fn);
+				});
+			});
+		}
+
+	private:
+		void check(size_t index) const {
+			if (index >= capacity()) {
+				throw std::out_of_range{ "numa_sparse_vector: index outside every region" };
+			}
+		}
+
+		void place(shard_type& shard, size_t node_index) {
+			std::byte* data{ reinterpret_cast<std::byte*>(std::to_address(shard.data())) };
+			size_t bytes{ shard.capacity() * sizeof(T) };
+
+			topology.bind(data, bytes, node_index);
+
+			size_t page{ numa_topology::page_size() };
+			for (size_t offset{ 0 }; offset < bytes; offset += page) {
+				data[offset] = std::byte{ 0 };
+			}
+		}
+
+		template<typename Fn>
+		void visit(size_t node_index, size_t begin, size_t end, Fn& fn) {
+			shard_type& shard{ shards[node_index] };
+			size_t base{ node_index * _region_capacity };
+
+			for (size_t bitset_index{ begin }; bitset_index < end; ++bitset_index) {
+				for (uint64_t _bitset{ shard.block(bitset_index).to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+					size_t local{ bitset_index * _BITSET_SIZE + std::countr_zero(_bitset) };
+					fn(base + local, shard[local]);
+				}
+			}
+		}
+	};
+
+}
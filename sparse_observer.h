@@ -0,0 +1,224 @@
+#pragma once
+
+#include <set>
+#include <bit>
+#include <span>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace Byte {
+
+	template<typename Sink>
+	class batched_observer {
+	private:
+		enum class event_type : uint8_t {
+			none,
+			insert,
+			erase
+		};
+
+	private:
+		Sink* sink;
+		std::vector<size_t> batch;
+		event_type pending{ event_type::none };
+		size_t batch_size;
+
+	public:
+		batched_observer(Sink& sink, size_t batch_size = 1024)
+			:sink{ &sink }, batch_size{ batch_size } {
+			batch.reserve(batch_size);
+		}
+
+		batched_observer(const batched_observer& right)
+			:sink{ right.sink }, batch_size{ right.batch_size } {
+			batch.reserve(batch_size);
+		}
+
+		batched_observer(batched_observer&& right) noexcept
+			:sink{ right.sink }, batch{ std::move(right.batch) }, pending{ right.pending }, batch_size{ right.batch_size } {
+			right.batch.clear();
+			right.pending = event_type::none;
+		}
+
+		~batched_observer() {
+			flush();
+		}
+
+		batched_observer& operator=(const batched_observer& right) {
+			if (this != &right) {
+				flush();
+				sink = right.sink;
+				batch_size = right.batch_size;
+			}
+			return *this;
+		}
+
+		batched_observer& operator=(batched_observer&& right) {
+			if (this != &right) {
+				flush();
+				sink = right.sink;
+				batch = std::move(right.batch);
+				pending = right.pending;
+				batch_size = right.batch_size;
+				right.batch.clear();
+				right.pending = event_type::none;
+			}
+			return *this;
+		}
+
+		void on_insert(size_t index) {
+			append(event_type::insert, index);
+		}
+
+		void on_erase(size_t index) {
+			append(event_type::erase, index);
+		}
+
+		void on_grow(size_t old_capacity, size_t new_capacity) {
+			flush();
+			sink->on_grow(old_capacity, new_capacity);
+		}
+
+		void flush() {
+			if (batch.empty()) {
+				return;
+			}
+
+			std::span<const size_t> indices{ batch };
+
+			if (pending == event_type::insert) {
+				sink->on_insert(indices);
+			}
+			else {
+				sink->on_erase(indices);
+			}
+
+			batch.clear();
+			pending = event_type::none;
+		}
+
+		size_t pending_count() const {
+			return batch.size();
+		}
+
+	private:
+		void append(event_type type, size_t index) {
+			if (pending != type || batch.size() == batch_size) {
+				flush();
+				pending = type;
+			}
+
+			batch.push_back(index);
+		}
+	};
+
+	class sampling_observer {
+	private:
+		std::vector<uint64_t> words;
+		std::vector<size_t> tree;
+		size_t _size{ 0 };
+
+	public:
+		void on_insert(size_t index) {
+			words[index / 64] |= uint64_t{ 1 } << (index % 64);
+			update(index / 64, 1);
+			++_size;
+		}
+
+		void on_erase(size_t index) {
+			words[index / 64] &= ~(uint64_t{ 1 } << (index % 64));
+			update(index / 64, -1);
+			--_size;
+		}
+
+		void on_grow(size_t, size_t new_capacity) {
+			size_t block_count{ (new_capacity + 63) / 64 };
+
+			if (block_count <= words.size()) {
+				return;
+			}
+
+			words.resize(block_count, 0);
+			tree.assign(block_count + 1, 0);
+
+			for (size_t position{ 1 }; position <= block_count; ++position) {
+				tree[position] += static_cast<size_t>(std::popcount(words[position - 1]));
+
+				size_t parent{ position + (position & (~position + 1)) };
+				if (parent <= block_count) {
+					tree[parent] += tree[position];
+				}
+			}
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		template<typename Rng>
+		size_t sample(Rng& rng) const {
+			if (_size == 0) {
+				return 64 * words.size();
+			}
+
+			return select(std::uniform_int_distribution<size_t>{ 0, _size - 1 }(rng));
+		}
+
+		template<typename Rng>
+		std::vector<size_t> sample_k(Rng& rng, size_t k) const {
+			std::vector<size_t> out;
+			k = std::min(k, _size);
+
+			std::set<size_t> chosen;
+			for (size_t rank{ _size - k }; rank < _size; ++rank) {
+				size_t candidate{ std::uniform_int_distribution<size_t>{ 0, rank }(rng) };
+				if (!chosen.insert(candidate).second) {
+					chosen.insert(rank);
+				}
+			}
+
+			out.reserve(k);
+			for (size_t rank : chosen) {
+				out.push_back(select(rank));
+			}
+
+			return out;
+		}
+
+	private:
+		void update(size_t block, int delta) {
+			for (size_t position{ block + 1 }; position < tree.size(); position += position & (~position + 1)) {
+				tree[position] += static_cast<size_t>(delta);
+			}
+		}
+
+		size_t select(size_t rank) const {
+			size_t position{ 0 };
+
+			for (size_t step{ std::bit_floor(tree.size() - 1) }; step != 0; step >>= 1) {
+				if (position + step < tree.size() && tree[position + step] <= rank) {
+					position += step;
+					rank -= tree[position];
+				}
+			}
+
+			uint64_t _bitset{ words[position] };
+
+#if defined(__BMI2__)
+			_bitset = _pdep_u64(uint64_t{ 1 } << rank, _bitset);
+#else
+			for (; rank > 0; --rank) {
+				_bitset &= _bitset - 1;
+			}
+#endif
+
+			return position * 64 + std::countr_zero(_bitset);
+		}
+	};
+
+}
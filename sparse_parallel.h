@@ -0,0 +1,60 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+namespace Byte {
+
+	inline size_t default_thread_count() {
+		size_t count{ std::thread::hardware_concurrency() };
+		return count == 0 ? 1 : count;
+	}
+
+	template<typename Fn>
+	void parallel_for(size_t count, size_t thread_count, Fn&& fn) {
+		thread_count = std::min(thread_count == 0 ? default_thread_count() : thread_count, count);
+
+		if (thread_count <= 1) {
+			if (count != 0) {
+				fn(size_t{ 0 }, size_t{ 0 }, count);
+			}
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		std::vector<std::exception_ptr> errors(thread_count);
+
+		threads.reserve(thread_count - 1);
+
+		auto run{ [&](size_t thread_index) {
+			size_t begin{ count * thread_index / thread_count };
+			size_t end{ count * (thread_index + 1) / thread_count };
+
+			try {
+				fn(thread_index, begin, end);
+			}
+			catch (...) {
+				errors[thread_index] = std::current_exception();
+			}
+		} };
+
+		for (size_t thread_index{ 1 }; thread_index < thread_count; ++thread_index) {
+			threads.emplace_back(run, thread_index);
+		}
+
+		run(0);
+
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+
+		for (std::exception_ptr& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+}
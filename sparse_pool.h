@@ -0,0 +1,266 @@
+#pragma once
+
+#include <utility>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	template<typename T, typename Allocator>
+	class sparse_pool;
+
+	template<typename T>
+	struct pool_slot {
+		T value;
+		size_t ref_count;
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class pool_ptr {
+	private:
+		using pool_type = sparse_pool<T, Allocator>;
+
+		inline static constexpr size_t npos{ std::numeric_limits<size_t>::max() };
+
+	private:
+		pool_type* pool{ nullptr };
+		size_t _index{ npos };
+
+	public:
+		pool_ptr() = default;
+
+		pool_ptr(pool_type& pool, size_t index)
+			:pool{ &pool }, _index{ index } {
+		}
+
+		pool_ptr(const pool_ptr&) = delete;
+
+		pool_ptr(pool_ptr&& right) noexcept
+			:pool{ right.pool }, _index{ right._index } {
+			right.pool = nullptr;
+			right._index = npos;
+		}
+
+		~pool_ptr() {
+			reset();
+		}
+
+		pool_ptr& operator=(const pool_ptr&) = delete;
+
+		pool_ptr& operator=(pool_ptr&& right) noexcept {
+			if (this != &right) {
+				reset();
+				std::swap(pool, right.pool);
+				std::swap(_index, right._index);
+			}
+			return *this;
+		}
+
+		T& operator*() const {
+			return pool->at(_index);
+		}
+
+		T* operator->() const {
+			return &pool->at(_index);
+		}
+
+		T* get() const {
+			return pool ? &pool->at(_index) : nullptr;
+		}
+
+		explicit operator bool() const {
+			return pool != nullptr;
+		}
+
+		size_t index() const {
+			return _index;
+		}
+
+		void reset() {
+			if (pool) {
+				pool->erase(_index);
+				pool = nullptr;
+				_index = npos;
+			}
+		}
+
+		[[maybe_unused]] size_t release() {
+			size_t out{ _index };
+			pool = nullptr;
+			_index = npos;
+			return out;
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class shared_pool_ptr {
+	private:
+		using pool_type = sparse_pool<T, Allocator>;
+
+		inline static constexpr size_t npos{ std::numeric_limits<size_t>::max() };
+
+	private:
+		pool_type* pool{ nullptr };
+		size_t _index{ npos };
+
+	public:
+		shared_pool_ptr() = default;
+
+		shared_pool_ptr(pool_type& pool, size_t index)
+			:pool{ &pool }, _index{ index } {
+		}
+
+		shared_pool_ptr(const shared_pool_ptr& left)
+			:pool{ left.pool }, _index{ left._index } {
+			if (pool) {
+				pool->acquire(_index);
+			}
+		}
+
+		shared_pool_ptr(shared_pool_ptr&& right) noexcept
+			:pool{ right.pool }, _index{ right._index } {
+			right.pool = nullptr;
+			right._index = npos;
+		}
+
+		~shared_pool_ptr() {
+			reset();
+		}
+
+		shared_pool_ptr& operator=(const shared_pool_ptr& left) {
+			shared_pool_ptr{ left }.swap(*this);
+			return *this;
+		}
+
+		shared_pool_ptr& operator=(shared_pool_ptr&& right) noexcept {
+			shared_pool_ptr{ std::move(right) }.swap(*this);
+			return *this;
+		}
+
+		T& operator*() const {
+			return pool->at(_index);
+		}
+
+		T* operator->() const {
+			return &pool->at(_index);
+		}
+
+		T* get() const {
+			return pool ? &pool->at(_index) : nullptr;
+		}
+
+		explicit operator bool() const {
+			return pool != nullptr;
+		}
+
+		size_t index() const {
+			return _index;
+		}
+
+		size_t use_count() const {
+			return pool ? pool->ref_count(_index) : 0;
+		}
+
+		void reset() {
+			if (pool) {
+				pool->release(_index);
+				pool = nullptr;
+				_index = npos;
+			}
+		}
+
+		void swap(shared_pool_ptr& left) noexcept {
+			std::swap(pool, left.pool);
+			std::swap(_index, left._index);
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class sparse_pool {
+	private:
+		using slot_type = pool_slot<T>;
+		using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot_type>;
+		using slot_vector = sparse_vector<slot_type, slot_allocator>;
+
+	public:
+		using value_type = T;
+		using unique_pointer = pool_ptr<T, Allocator>;
+		using shared_pointer = shared_pool_ptr<T, Allocator>;
+
+	private:
+		slot_vector slots;
+
+	public:
+		sparse_pool(size_t initial_capacity = _BITSET_SIZE)
+			:slots{ initial_capacity } {
+		}
+
+		sparse_pool(const sparse_pool&) = delete;
+
+		sparse_pool& operator=(const sparse_pool&) = delete;
+
+		template<class... Args>
+		unique_pointer make(Args&&... args) {
+			return unique_pointer{ *this, slots.emplace(slot_type{ T(std::forward<Args>(args)...), 1 }) };
+		}
+
+		template<class... Args>
+		shared_pointer make_shared(Args&&... args) {
+			return shared_pointer{ *this, slots.emplace(slot_type{ T(std::forward<Args>(args)...), 1 }) };
+		}
+
+		T& at(size_t index) {
+			return slots[index].value;
+		}
+
+		const T& at(size_t index) const {
+			return slots[index].value;
+		}
+
+		bool test(size_t index) const {
+			return slots.test(index);
+		}
+
+		size_t size() const {
+			return slots.size();
+		}
+
+		bool empty() const {
+			return slots.empty();
+		}
+
+		size_t capacity() const {
+			return slots.capacity();
+		}
+
+		template<typename Fn>
+		void for_each(Fn&& fn) {
+			for (auto it{ slots.begin() }; it != slots.end(); ++it) {
+				fn(it.index(), it->value);
+			}
+		}
+
+	private:
+		friend unique_pointer;
+		friend shared_pointer;
+
+		void erase(size_t index) {
+			slots.erase(index);
+		}
+
+		void acquire(size_t index) {
+			++slots[index].ref_count;
+		}
+
+		void release(size_t index) {
+			if (--slots[index].ref_count == 0) {
+				slots.erase(index);
+			}
+		}
+
+		size_t ref_count(size_t index) const {
+			return slots[index].ref_count;
+		}
+	};
+
+}
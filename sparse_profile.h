@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace Byte {
+
+	inline static constexpr size_t _PROFILE_SAMPLE_INTERVAL{ 1024 };
+	inline static constexpr size_t _PROFILE_SAMPLE_LIMIT{ 4096 };
+
+	struct density_sample {
+		uint64_t operation;
+		size_t size;
+		size_t capacity;
+	};
+
+	class container_profile {
+	private:
+		std::string _name;
+		uint64_t _pushes{ 0 };
+		uint64_t _inserts{ 0 };
+		uint64_t _erases{ 0 };
+		uint64_t _iterations{ 0 };
+		uint64_t _grows{ 0 };
+		uint64_t _monotonic_additions{ 0 };
+		double _erase_age{ 0.0 };
+		double _iteration_density{ 0.0 };
+		size_t _size{ 0 };
+		size_t _capacity{ 0 };
+		size_t _initial_capacity{ 0 };
+		size_t _peak_size{ 0 };
+		size_t _peak_capacity{ 0 };
+		size_t _high_water{ 0 };
+		size_t _sample_interval{ _PROFILE_SAMPLE_INTERVAL };
+		std::vector<density_sample> _samples;
+
+	public:
+		explicit container_profile(std::string name)
+			:_name{ std::move(name) } {
+		}
+
+		void push(size_t index) {
+			++_pushes;
+			added(index);
+		}
+
+		void insert(size_t index) {
+			++_inserts;
+			added(index);
+		}
+
+		void erase(size_t index) {
+			++_erases;
+			if (_size != 0) {
+				_erase_age += std::min(1.0, static_cast<double>(_high_water - std::min(index, _high_water)) / static_cast<double>(_size));
+			}
+			--_size;
+			tick();
+		}
+
+		void grow(size_t old_capacity, size_t new_capacity) {
+			if (old_capacity == 0) {
+				_initial_capacity = new_capacity;
+			}
+			else {
+				++_grows;
+			}
+			_capacity = new_capacity;
+			_peak_capacity = std::max(_peak_capacity, new_capacity);
+		}
+
+		void shrink(size_t new_capacity) {
+			_capacity = new_capacity;
+		}
+
+		void iterate() {
+			++_iterations;
+			if (_capacity != 0) {
+				_iteration_density += static_cast<double>(_size) / static_cast<double>(_capacity);
+			}
+			tick();
+		}
+
+		const std::string& name() const {
+			return _name;
+		}
+
+		uint64_t operations() const {
+			return _pushes + _inserts + _erases + _iterations;
+		}
+
+		const std::vector<density_sample>& samples() const {
+			return _samples;
+		}
+
+		double mean_density() const {
+			if (_samples.empty()) {
+				return _capacity == 0 ? 0.0 : static_cast<double>(_size) / static_cast<double>(_capacity);
+			}
+
+			double sum{ 0.0 };
+			for (const density_sample& sample : _samples) {
+				sum += sample.capacity == 0 ? 0.0 : static_cast<double>(sample.size) / static_cast<double>(sample.capacity);
+			}
+			return sum / static_cast<double>(_samples.size());
+		}
+
+		std::vector<std::string> advise() const {
+			std::vector<std::string> out;
+			uint64_t additions{ _pushes + _inserts };
+
+			if (_grows > 0) {
+				out.push_back("reserve " + quantity(std::max(_peak_size, _high_water)) + " (avoids " + std::to_string(_grows) + " expand() doublings from an initial capacity of " + quantity(_initial_capacity) + ")");
+			}
+
+			if (_peak_size != 0 && _size * 4 < _peak_size && _capacity > 2 * std::max<size_t>(_size, 64)) {
+				out.push_back("call shrink_to_fit() after bursts to release trailing empty blocks (live size fell to " + percent(static_cast<double>(_size) / static_cast<double>(_peak_size)) + " of peak)");
+			}
+
+			if (additions > 1024 && _erases * 10 > additions * 8 && _monotonic_additions * 10 > additions * 9 && _erase_age > 0.8 * static_cast<double>(_erases) && _peak_size * 4 < _high_water) {
+				out.push_back("use sparse_ring (additions are monotonic and erases remove the oldest indices)");
+			}
+
+			double density{ _iterations == 0 ? 1.0 : _iteration_density / static_cast<double>(_iterations) };
+			if (_iterations > 0 && density < 0.25 && _iterations * 1000 > operations()) {
+				out.push_back("iteration visits " + percent(density) + " live slots on average; call shrink_to_fit() to drop trailing empty blocks, or iterate a make_view() whose predicate selects the slots the loop needs");
+			}
+
+			if (additions > 0 && _erases * 2 > additions && _iterations == 0) {
+				out.push_back("erase-heavy churn without iteration (erase/add " + ratio(static_cast<double>(_erases) / static_cast<double>(additions)) + "); a sparse_pool keeps lifetimes explicit");
+			}
+
+			if (out.empty()) {
+				out.push_back("current configuration fits the observed workload");
+			}
+
+			return out;
+		}
+
+		std::string report() const {
+			std::ostringstream out;
+
+			out << '[' << _name << "] pushes=" << _pushes << " inserts=" << _inserts << " erases=" << _erases
+				<< " iterations=" << _iterations << " grows=" << _grows
+				<< " peak_size=" << _peak_size << " peak_capacity=" << _peak_capacity
+				<< " mean_density=" << percent(mean_density()) << '\n';
+
+			for (const std::string& recommendation : advise()) {
+				out << "  - " << recommendation << '\n';
+			}
+
+			return out.str();
+		}
+
+	private:
+		void added(size_t index) {
+			if (index >= _high_water) {
+				++_monotonic_additions;
+			}
+			_high_water = std::max(_high_water, index + 1);
+			++_size;
+			_peak_size = std::max(_peak_size, _size);
+			tick();
+		}
+
+		void tick() {
+			uint64_t operation{ operations() };
+
+			if (operation % _sample_interval != 0) {
+				return;
+			}
+
+			if (_samples.size() == _PROFILE_SAMPLE_LIMIT) {
+				for (size_t index{ 0 }; index < _samples.size() / 2; ++index) {
+					_samples[index] = _samples[2 * index];
+				}
+				_samples.resize(_samples.size() / 2);
+				_sample_interval *= 2;
+			}
+
+			_samples.push_back(density_sample{ operation, _size, _capacity });
+		}
+
+		static std::string quantity(size_t value) {
+			std::ostringstream out;
+
+			if (value >= 1000000) {
+				out << std::fixed << std::setprecision(1) << static_cast<double>(value) / 1e6 << 'M';
+			}
+			else if (value >= 1000) {
+				out << std::fixed << std::setprecision(1) << static_cast<double>(value) / 1e3 << 'K';
+			}
+			else {
+				out << value;
+			}
+
+			return out.str();
+		}
+
+		static std::string percent(double value) {
+			std::ostringstream out;
+			out << std::fixed << std::setprecision(1) << value * 100.0 << '%';
+			return out.str();
+		}
+
+		static std::string ratio(double value) {
+			std::ostringstream out;
+			out << std::fixed << std::setprecision(2) << value;
+			return out.str();
+		}
+	};
+
+	class profiling_observer {
+	private:
+		container_profile* profile;
+
+	public:
+		profiling_observer() = delete;
+
+		profiling_observer(container_profile& profile)
+			:profile{ &profile } {
+		}
+
+		void on_push(size_t index) {
+			profile->push(index);
+		}
+
+		void on_insert(size_t index) {
+			profile->insert(index);
+		}
+
+		void on_erase(size_t index) {
+			profile->erase(index);
+		}
+
+		void on_grow(size_t old_capacity, size_t new_capacity) {
+			profile->grow(old_capacity, new_capacity);
+		}
+
+		void on_shrink(size_t, size_t new_capacity) {
+			profile->shrink(new_capacity);
+		}
+
+		void on_iterate() {
+			profile->iterate();
+		}
+	};
+
+	inline std::string profile_report(const std::vector<const container_profile*>& profiles) {
+		std::string out;
+		for (const container_profile* profile : profiles) {
+			out += profile->report();
+		}
+		return out;
+	}
+
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	template<typename Ring, typename T>
+	class sparse_ring_iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = value_type&;
+
+	private:
+		Ring* ring;
+		size_t _index;
+
+	public:
+		sparse_ring_iterator(Ring* ring, size_t index)
+			:ring{ ring }, _index{ index } {
+		}
+
+		reference operator*() const {
+			return ring->at(_index);
+		}
+
+		pointer operator->() const {
+			return &ring->at(_index);
+		}
+
+		sparse_ring_iterator& operator++() {
+			_index = ring->find_next(_index + 1);
+			return *this;
+		}
+
+		sparse_ring_iterator operator++(int) {
+			sparse_ring_iterator out{ *this };
+			++(*this);
+			return out;
+		}
+
+		bool operator==(const sparse_ring_iterator& left) const {
+			return _index == left._index;
+		}
+
+		bool operator!=(const sparse_ring_iterator& left) const {
+			return _index != left._index;
+		}
+
+		size_t index() const {
+			return _index;
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class sparse_ring {
+	private:
+		using bitset64 = std::bitset<_BITSET_SIZE>;
+		using bitset_vector = std::vector<bitset64>;
+		using allocator_traits = std::allocator_traits<Allocator>;
+
+	public:
+		using value_type = T;
+		using allocator_type = Allocator;
+		using pointer = typename allocator_traits::pointer;
+		using reference = T&;
+		using const_reference = const T&;
+		using iterator = sparse_ring_iterator<sparse_ring, T>;
+		using const_iterator = sparse_ring_iterator<const sparse_ring, const T>;
+
+	private:
+		pointer _data{ nullptr };
+		bitset_vector bitsets;
+		size_t _size{ 0 };
+		size_t _capacity{ 0 };
+		size_t _base{ 0 };
+		allocator_type allocator;
+
+	public:
+		sparse_ring(size_t initial_capacity = _BITSET_SIZE) {
+			resize(std::bit_ceil(initial_capacity < _BITSET_SIZE ? _BITSET_SIZE : initial_capacity));
+		}
+
+		sparse_ring(const sparse_ring&) = delete;
+
+		sparse_ring(sparse_ring&& right) noexcept
+			:_data{ right._data },
+			bitsets{ std::move(right.bitsets) },
+			_size{ right._size },
+			_capacity{ right._capacity },
+			_base{ right._base },
+			allocator{ std::move(right.allocator) } {
+			right._data = nullptr;
+			right._size = 0;
+			right._capacity = 0;
+		}
+
+		~sparse_ring() {
+			advance(_base + _capacity);
+			if (_data) {
+				allocator_traits::deallocate(allocator, _data, _capacity);
+			}
+		}
+
+		sparse_ring& operator=(const sparse_ring&) = delete;
+
+		void insert(size_t index, const T& value) {
+			insert(index, T{ value });
+		}
+
+		void insert(size_t index, T&& value) {
+			if (index < _base) {
+				throw std::out_of_range{ "sparse_ring::insert before window base" };
+			}
+
+			if (index - _base >= _capacity) {
+				resize(std::bit_ceil(index - _base + 1));
+			}
+
+			if (test(index)) {
+				at(index) = std::move(value);
+				return;
+			}
+
+			size_t slot{ index & (_capacity - 1) };
+			bitsets[slot / _BITSET_SIZE].set(slot % _BITSET_SIZE);
+			allocator_traits::construct(allocator, _data + slot, std::move(value));
+			++_size;
+		}
+
+		void erase(size_t index) {
+			size_t slot{ index & (_capacity - 1) };
+
+			bitsets[slot / _BITSET_SIZE].set(slot % _BITSET_SIZE, false);
+			allocator_traits::destroy(allocator, _data + slot);
+			--_size;
+		}
+
+		void advance(size_t new_base) {
+			if (new_base <= _base) {
+				return;
+			}
+
+			size_t aligned_base{ _base - _base % _BITSET_SIZE };
+			size_t last{ std::min(new_base, _base + _capacity) };
+
+			for (size_t block{ aligned_base }; block < last; block += _BITSET_SIZE) {
+				size_t begin{ std::max(block, _base) - block };
+				size_t end{ std::min(block + _BITSET_SIZE, last) - block };
+
+				erase_block(block, (std::numeric_limits<uint64_t>::max() >> (_BITSET_SIZE - (end - begin))) << begin);
+			}
+
+			_base = new_base;
+		}
+
+		void shrink_to_fit() {
+			size_t last{ _base };
+
+			for (size_t index{ find_next(_base) }; index != end_index(); index = find_next(index + 1)) {
+				last = index;
+			}
+
+			size_t new_capacity{ std::bit_ceil(last - _base + 1) };
+			if (new_capacity < _BITSET_SIZE) {
+				new_capacity = _BITSET_SIZE;
+			}
+
+			if (new_capacity < _capacity) {
+				resize(new_capacity);
+			}
+		}
+
+		bool test(size_t index) const {
+			if (index < _base || index - _base >= _capacity) {
+				return false;
+			}
+
+			size_t slot{ index & (_capacity - 1) };
+			return bitsets[slot / _BITSET_SIZE].test(slot % _BITSET_SIZE);
+		}
+
+		reference at(size_t index) {
+			return _data[index & (_capacity - 1)];
+		}
+
+		const_reference at(size_t index) const {
+			return _data[index & (_capacity - 1)];
+		}
+
+		reference operator[](size_t index) {
+			return at(index);
+		}
+
+		const_reference operator[](size_t index) const {
+			return at(index);
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		size_t capacity() const {
+			return _capacity;
+		}
+
+		size_t base() const {
+			return _base;
+		}
+
+		iterator begin() {
+			return iterator{ this, find_next(_base) };
+		}
+
+		iterator end() {
+			return iterator{ this, end_index() };
+		}
+
+		const_iterator begin() const {
+			return const_iterator{ this, find_next(_base) };
+		}
+
+		const_iterator end() const {
+			return const_iterator{ this, end_index() };
+		}
+
+		size_t find_next(size_t index) const {
+			for (; index < end_index(); index += _BITSET_SIZE - index % _BITSET_SIZE) {
+				size_t slot{ index & (_capacity - 1) };
+				uint64_t _bitset{ bitsets[slot / _BITSET_SIZE].to_ullong() >> (slot % _BITSET_SIZE) };
+
+				if (_bitset != 0) {
+					return std::min(index + std::countr_zero(_bitset), end_index());
+				}
+			}
+
+			return end_index();
+		}
+
+	private:
+		size_t end_index() const {
+			return _base + _capacity;
+		}
+
+		void erase_block(size_t block, uint64_t mask) {
+			size_t slot{ block & (_capacity - 1) };
+			bitset64& _bitset{ bitsets[slot / _BITSET_SIZE] };
+			uint64_t erased{ _bitset.to_ullong() & mask };
+
+			if (!std::is_trivially_destructible<T>::value) {
+				for (uint64_t bits{ erased }; bits != 0; bits &= bits - 1) {
+					allocator_traits::destroy(allocator, _data + slot + std::countr_zero(bits));
+				}
+			}
+
+			_size -= std::popcount(erased);
+			_bitset = bitset64{ _bitset.to_ullong() & ~mask };
+		}
+
+		void resize(size_t new_capacity) {
+			pointer new_data{ allocator_traits::allocate(allocator, new_capacity) };
+			bitset_vector new_bitsets(new_capacity / _BITSET_SIZE);
+
+			if (_data) {
+				for (size_t index{ find_next(_base) }; index != end_index(); index = find_next(index + 1)) {
+					size_t slot{ index & (new_capacity - 1) };
+					allocator_traits::construct(allocator, new_data + slot, std::move(at(index)));
+					allocator_traits::destroy(allocator, _data + (index & (_capacity - 1)));
+					new_bitsets[slot / _BITSET_SIZE].set(slot % _BITSET_SIZE);
+				}
+
+				allocator_traits::deallocate(allocator, _data, _capacity);
+			}
+
+			_data = new_data;
+			bitsets = std::move(new_bitsets);
+			_capacity = new_capacity;
+		}
+	};
+
+}
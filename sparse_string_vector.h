@@ -0,0 +1,191 @@
+#pragma once
+
+#include <string_view>
+#include <cstring>
+
+#include "sparse_vector.h"
+
+namespace Byte {
+
+	inline static constexpr size_t _STRING_CHUNK_SIZE{ 256 * 1024 };
+
+	class sparse_string_vector {
+	private:
+		inline static constexpr size_t _INLINE_CAPACITY{ 23 };
+		inline static constexpr uint8_t _ARENA_TAG{ 0xFF };
+
+		struct string_slot {
+			char bytes[_INLINE_CAPACITY];
+			uint8_t tag;
+		};
+
+		struct arena_ref {
+			uint32_t chunk;
+			uint32_t offset;
+			uint64_t length;
+		};
+
+		struct arena_chunk {
+			std::unique_ptr<char[]> data;
+			size_t capacity;
+			size_t used;
+		};
+
+		using slot_vector = sparse_vector<string_slot>;
+		using chunk_pointer = std::shared_ptr<arena_chunk>;
+
+	public:
+		using value_type = std::string_view;
+
+	private:
+		slot_vector slots;
+		std::vector<chunk_pointer> chunks;
+		size_t _arena_bytes{ 0 };
+		size_t _garbage_bytes{ 0 };
+
+	public:
+		sparse_string_vector(size_t initial_capacity = _BITSET_SIZE)
+			:slots{ initial_capacity } {
+		}
+
+		[[maybe_unused]] size_t push(std::string_view value) {
+			return slots.push(store(value));
+		}
+
+		void insert(size_t index, std::string_view value) {
+			if (slots.test(index)) {
+				erase(index);
+			}
+
+			slots.insert(index, store(value));
+		}
+
+		void erase(size_t index) {
+			const string_slot& slot{ slots[index] };
+
+			if (slot.tag == _ARENA_TAG) {
+				_garbage_bytes += reference(slot).length;
+			}
+
+			slots.erase(index);
+		}
+
+		std::string_view at(size_t index) const {
+			const string_slot& slot{ slots[index] };
+
+			if (slot.tag != _ARENA_TAG) {
+				return std::string_view{ slot.bytes, slot.tag };
+			}
+
+			arena_ref ref{ reference(slot) };
+			return std::string_view{ chunks[ref.chunk]->data.get() + ref.offset, ref.length };
+		}
+
+		std::string_view operator[](size_t index) const {
+			return at(index);
+		}
+
+		bool test(size_t index) const {
+			return slots.test(index);
+		}
+
+		size_t size() const {
+			return slots.size();
+		}
+
+		bool empty() const {
+			return slots.empty();
+		}
+
+		size_t capacity() const {
+			return slots.capacity();
+		}
+
+		size_t arena_bytes() const {
+			return _arena_bytes;
+		}
+
+		size_t garbage_bytes() const {
+			return _garbage_bytes;
+		}
+
+		template<typename Fn>
+		void for_each(Fn&& fn) const {
+			for (auto it{ slots.begin() }; it != slots.end(); ++it) {
+				fn(it.index(), at(it.index()));
+			}
+		}
+
+		void clear() {
+			slots.clear();
+			chunks.clear();
+			_arena_bytes = 0;
+			_garbage_bytes = 0;
+		}
+
+		sparse_string_vector snapshot() const {
+			sparse_string_vector out{ 0 };
+
+			out.slots = slots;
+			out.chunks = chunks;
+			out._arena_bytes = _arena_bytes;
+			out._garbage_bytes = _garbage_bytes;
+
+			return out;
+		}
+
+		void compact() {
+			std::vector<chunk_pointer> old_chunks{ std::move(chunks) };
+
+			chunks.clear();
+			_arena_bytes = 0;
+			_garbage_bytes = 0;
+
+			for (auto it{ slots.begin() }; it != slots.end(); ++it) {
+				string_slot& slot{ *it };
+
+				if (slot.tag != _ARENA_TAG) {
+					continue;
+				}
+
+				arena_ref ref{ reference(slot) };
+				slot = store(std::string_view{ old_chunks[ref.chunk]->data.get() + ref.offset, ref.length });
+			}
+		}
+
+	private:
+		static arena_ref reference(const string_slot& slot) {
+			arena_ref ref;
+			std::memcpy(&ref, slot.bytes, sizeof(arena_ref));
+			return ref;
+		}
+
+		string_slot store(std::string_view value) {
+			string_slot slot;
+
+			if (value.size() <= _INLINE_CAPACITY) {
+				std::memcpy(slot.bytes, value.data(), value.size());
+				slot.tag = static_cast<uint8_t>(value.size());
+				return slot;
+			}
+
+			if (chunks.empty() || chunks.back()->used + value.size() > chunks.back()->capacity) {
+				size_t chunk_size{ value.size() > _STRING_CHUNK_SIZE ? value.size() : _STRING_CHUNK_SIZE };
+				chunks.push_back(std::make_shared<arena_chunk>(arena_chunk{ std::make_unique_for_overwrite<char[]>(chunk_size), chunk_size, 0 }));
+			}
+
+			arena_chunk& chunk{ *chunks.back() };
+			arena_ref ref{ static_cast<uint32_t>(chunks.size() - 1), static_cast<uint32_t>(chunk.used), value.size() };
+
+			std::memcpy(chunk.data.get() + chunk.used, value.data(), value.size());
+			chunk.used += value.size();
+			_arena_bytes += value.size();
+
+			std::memcpy(slot.bytes, &ref, sizeof(arena_ref));
+			slot.tag = _ARENA_TAG;
+
+			return slot;
+		}
+	};
+
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Byte {
+
+	enum class trace_operation : uint8_t {
+		push,
+		insert,
+		erase,
+		grow,
+		iterate
+	};
+
+	struct trace_event {
+		trace_operation operation;
+		uint64_t index;
+		uint64_t timestamp;
+	};
+
+	class operation_trace {
+	private:
+		using clock = std::chrono::steady_clock;
+
+		inline static constexpr char _MAGIC[4]{ 'S', 'V', 'T', 'R' };
+		inline static constexpr uint8_t _VERSION{ 1 };
+
+	private:
+		std::vector<uint8_t> buffer;
+		clock::time_point start{ clock::now() };
+		uint64_t last_timestamp{ 0 };
+		size_t _size{ 0 };
+
+	public:
+		void record(trace_operation operation, uint64_t index) {
+			uint64_t timestamp{ static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count()) };
+
+			buffer.push_back(static_cast<uint8_t>(operation));
+			put(index);
+			put(timestamp - last_timestamp);
+
+			last_timestamp = timestamp;
+			++_size;
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		size_t bytes() const {
+			return buffer.size();
+		}
+
+		void clear() {
+			buffer.clear();
+			start = clock::now();
+			last_timestamp = 0;
+			_size = 0;
+		}
+
+		template<typename Fn>
+		void for_each(Fn&& fn) const {
+			uint64_t timestamp{ 0 };
+
+			for (size_t position{ 0 }; position < buffer.size();) {
+				trace_operation operation{ static_cast<trace_operation>(buffer[position++]) };
+				uint64_t index{ get(position) };
+
+				timestamp += get(position);
+				fn(trace_event{ operation, index, timestamp });
+			}
+		}
+
+		void save(const std::string& path) const {
+			std::ofstream file{ path, std::ios::binary };
+			uint64_t count{ _size };
+
+			file.write(_MAGIC, sizeof(_MAGIC));
+			file.put(static_cast<char>(_VERSION));
+			file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+			file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+			if (!file) {
+				throw std::runtime_error{ "operation_trace: cannot write " + path };
+			}
+		}
+
+		static operation_trace load(const std::string& path) {
+			std::ifstream file{ path, std::ios::binary | std::ios::ate };
+			if (!file) {
+				throw std::runtime_error{ "operation_trace: cannot open " + path };
+			}
+
+			size_t length{ static_cast<size_t>(file.tellg()) };
+			char magic[sizeof(_MAGIC)]{};
+			uint64_t count{ 0 };
+
+			file.seekg(0);
+			file.read(magic, sizeof(magic));
+
+			if (length < sizeof(_MAGIC) + 1 + sizeof(count) || !std::equal(magic, magic + sizeof(magic), _MAGIC) || file.get() != _VERSION) {
+				throw std::runtime_error{ "operation_trace: unsupported trace " + path };
+			}
+
+			file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+			operation_trace out;
+			out.buffer.resize(length - sizeof(_MAGIC) - 1 - sizeof(count));
+			out._size = static_cast<size_t>(count);
+			file.read(reinterpret_cast<char*>(out.buffer.data()), static_cast<std::streamsize>(out.buffer.size()));
+
+			return out;
+		}
+
+	private:
+		void put(uint64_t value) {
+			for (; value >= 0x80; value >>= 7) {
+				buffer.push_back(static_cast<uint8_t>(value | 0x80));
+			}
+			buffer.push_back(static_cast<uint8_t>(value));
+		}
+
+		uint64_t get(size_t& position) const {
+			uint64_t value{ 0 };
+
+			for (size_t shift{ 0 }; position < buffer.size(); shift += 7) {
+				uint8_t byte{ buffer[position++] };
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+				if ((byte & 0x80) == 0) {
+					break;
+				}
+			}
+
+			return value;
+		}
+	};
+
+	class trace_observer {
+	private:
+		operation_trace* trace;
+
+	public:
+		trace_observer() = delete;
+
+		trace_observer(operation_trace& trace)
+			:trace{ &trace } {
+		}
+
+		void on_push(size_t index) {
+			trace->record(trace_operation::push, index);
+		}
+
+		void on_insert(size_t index) {
+			trace->record(trace_operation::insert, index);
+		}
+
+		void on_erase(size_t index) {
+			trace->record(trace_operation::erase, index);
+		}
+
+		void on_grow(size_t, size_t new_capacity) {
+			trace->record(trace_operation::grow, new_capacity);
+		}
+
+		void on_iterate() {
+			trace->record(trace_operation::iterate, 0);
+		}
+	};
+
+}
@@ -7,6 +7,13 @@
 #include <limits>
 #include <set>
 #include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <ranges>
+
+#include "sparse_parallel.h"
 
 namespace Byte {
 
@@ -51,7 +58,7 @@ namespace Byte {
 			for (size_t bitset_index{ _index / _BITSET_SIZE }; bitset_index < bitsets_ptr->size(); ++bitset_index) {
 				size_t _bitset{ bitsets_ptr->at(bitset_index).to_ullong() };
 				size_t bit_count{ _index % 64 };
-				size_t mask{ bit_count == 0 ? std::numeric_limits<uint64_t>::max() : (1ULL << bit_count) };
+				size_t mask{ std::numeric_limits<uint64_t>::max() << bit_count };
 
 				_bitset &= mask;
 
@@ -85,7 +92,18 @@ namespace Byte {
 		}
 	};
 
-	template<typename T, typename Allocator = std::allocator<T>>
+	struct null_observer {
+		void on_insert(size_t) {
+		}
+
+		void on_erase(size_t) {
+		}
+
+		void on_grow(size_t, size_t) {
+		}
+	};
+
+	template<typename T, typename Allocator = std::allocator<T>, typename Observer = null_observer>
 	class sparse_vector {
 	private:
 		using bitset64 = std::bitset<_BITSET_SIZE>;
@@ -93,9 +111,12 @@ namespace Byte {
 		using index_set = std::set<size_t>;
 		using allocator_traits = std::allocator_traits<Allocator>;
 
+		inline static constexpr bool _OBSERVED{ !std::is_same<Observer, null_observer>::value };
+
 	public:
 		using value_type = T;
 		using allocator_type = Allocator;
+		using observer_type = Observer;
 		using pointer = typename allocator_traits::pointer;
 		using const_pointer = typename allocator_traits::const_pointer;
 		using reference = T&;
@@ -112,9 +133,15 @@ namespace Byte {
 		size_t _size{ 0 };
 		size_t _capacity{ 0 };
 		allocator_type allocator;
+		[[no_unique_address]] mutable observer_type _observer;
 
 	public:
-		sparse_vector(size_t initial_capacity = _BITSET_SIZE) {
+		sparse_vector(size_t initial_capacity = _BITSET_SIZE)
+			:sparse_vector{ initial_capacity, observer_type{} } {
+		}
+
+		sparse_vector(size_t initial_capacity, observer_type observer)
+			:_observer{ std::move(observer) } {
 			if (initial_capacity % _BITSET_SIZE != 0) {
 				initial_capacity += _BITSET_SIZE - (initial_capacity % _BITSET_SIZE);
 			}
@@ -131,18 +158,26 @@ namespace Byte {
 			indices{ std::move(right.indices) },
 			_size{ right._size },
 			_capacity{ right._capacity },
-			allocator{ std::move(right.allocator) } {
+			allocator{ std::move(right.allocator) },
+			_observer{ std::move(right._observer) } {
 			right._data = nullptr;
 			right._size = 0;
 			right._capacity = 0;
 		}
 
-		sparse_vector& operator=(const sparse_vector left) {
-			(*this) = left.copy();
+		~sparse_vector() {
+			release();
+		}
+
+		sparse_vector& operator=(const sparse_vector& left) {
+			if (this != &left) {
+				(*this) = left.copy();
+			}
+			return *this;
 		}
 
 		sparse_vector& operator=(sparse_vector&& right) noexcept {
-			clear();
+			release();
 
 			_data = right._data;
 			bitsets = std::move(right.bitsets);
@@ -150,10 +185,13 @@ namespace Byte {
 			_size = right._size;
 			_capacity = right._capacity;
 			allocator = std::move(right.allocator);
+			_observer = std::move(right._observer);
 
 			right._data = nullptr;
 			right._size = 0;
 			right._capacity = 0;
+
+			return *this;
 		}
 
 		[[maybe_unused]] size_t push(const T& value) {
@@ -164,6 +202,7 @@ namespace Byte {
 			size_t index{ free_index() };
 
 			_emplace(index, std::move(value));
+			notify_push(index);
 
 			return index;
 		}
@@ -174,16 +213,181 @@ namespace Byte {
 
 		void insert(size_t index, T&& value) {
 			_emplace(index, std::move(value));
+			_observer.on_insert(index);
 		}
 
 		template<class... Args>
 		[[maybe_unused]] size_t emplace(Args&&... args) {
 			size_t index{ free_index() };
 			_emplace(index, std::move(args)...);
+			notify_push(index);
 
 			return index;
 		}
 
+		void insert_parallel(std::span<std::vector<std::pair<size_t, T>>> batches, size_t thread_count = 0) {
+			size_t batch_count{ batches.size() };
+			std::vector<size_t> limits(batch_count, 0);
+
+			parallel_for(batch_count, thread_count, [&](size_t, size_t begin, size_t end) {
+				for (size_t batch{ begin }; batch < end; ++batch) {
+					for (const auto& entry : batches[batch]) {
+						limits[batch] = std::max(limits[batch], entry.first + 1);
+					}
+				}
+			});
+
+			size_t limit{ 0 };
+			for (size_t batch_limit : limits) {
+				limit = std::max(limit, batch_limit);
+			}
+
+			if (limit == 0) {
+				return;
+			}
+
+			reserve(limit);
+
+			size_t partition_count{ std::min(thread_count == 0 ? default_thread_count() : thread_count, bitsets.size()) };
+			size_t block_count{ bitsets.size() };
+			std::vector<std::vector<std::vector<size_t>>> buckets(batch_count, std::vector<std::vector<size_t>>(partition_count));
+
+			parallel_for(batch_count, thread_count, [&](size_t, size_t begin, size_t end) {
+				for (size_t batch{ begin }; batch < end; ++batch) {
+					for (size_t position{ 0 }; position < batches[batch].size(); ++position) {
+						size_t bitset_index{ batches[batch][position].first / _BITSET_SIZE };
+						buckets[batch][((bitset_index + 1) * partition_count + block_count - 1) / block_count - 1].push_back(position);
+					}
+				}
+			});
+
+			std::vector<size_t> added(partition_count, 0);
+			std::vector<std::vector<size_t>> full_blocks(partition_count);
+			std::vector<std::vector<size_t>> inserted(_OBSERVED ? partition_count : 0);
+
+			auto finish{ [&] {
+				for (size_t partition{ 0 }; partition < partition_count; ++partition) {
+					_size += added[partition];
+
+					for (size_t bitset_index : full_blocks[partition]) {
+						indices.erase(bitset_index);
+					}
+
+					if constexpr (_OBSERVED) {
+						for (size_t index : inserted[partition]) {
+							_observer.on_insert(index);
+						}
+					}
+				}
+			} };
+
+			try {
+				parallel_for(partition_count, partition_count, [&](size_t, size_t begin, size_t end) {
+					for (size_t partition{ begin }; partition < end; ++partition) {
+						auto collect_full{ [&] {
+							for (size_t bitset_index{ block_count * partition / partition_count }; bitset_index < block_count * (partition + 1) / partition_count; ++bitset_index) {
+								if (bitsets[bitset_index].all()) {
+									full_blocks[partition].push_back(bitset_index);
+								}
+							}
+						} };
+
+						try {
+							for (size_t batch{ 0 }; batch < batch_count; ++batch) {
+								for (size_t position : buckets[batch][partition]) {
+									auto& [index, value] { batches[batch][position] };
+
+									if (test(index)) {
+										_data[index] = std::move(value);
+										continue;
+									}
+
+									construct(_data + index, std::move(value));
+									bitsets[index / _BITSET_SIZE].set(index % _BITSET_SIZE);
+									++added[partition];
+
+									if constexpr (_OBSERVED) {
+										inserted[partition].push_back(index);
+									}
+								}
+							}
+						}
+						catch (...) {
+							collect_full();
+							throw;
+						}
+
+						collect_full();
+					}
+				});
+			}
+			catch (...) {
+				finish();
+				throw;
+			}
+
+			finish();
+		}
+
+		void assign(size_t count, const T& value, size_t thread_count = 0) {
+			reset(count);
+			fill(count, thread_count, [&](size_t) -> const T& {
+				return value;
+			});
+		}
+
+		template<std::ranges::input_range Range>
+		void assign(Range&& range, size_t thread_count = 0) {
+			if constexpr (std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>) {
+				size_t count{ static_cast<size_t>(std::ranges::size(range)) };
+				auto _begin{ std::ranges::begin(range) };
+
+				reset(count);
+				fill(count, thread_count, [&](size_t index) -> decltype(auto) {
+					if constexpr (std::is_lvalue_reference<std::ranges::range_reference_t<Range>>::value) {
+						return std::as_const(_begin[index]);
+					}
+					else {
+						return _begin[index];
+					}
+				});
+			}
+			else {
+				std::vector<T> values;
+				for (auto&& value : range) {
+					values.emplace_back(std::forward<decltype(value)>(value));
+				}
+
+				reset(values.size());
+				fill(values.size(), thread_count, [&](size_t index) -> T&& {
+					return std::move(values[index]);
+				});
+			}
+		}
+
+		template<typename Generator>
+		void resize_filled(size_t count, Generator generator, size_t thread_count = 0) {
+			if (count > _capacity) {
+				expand(count + (_BITSET_SIZE - count % _BITSET_SIZE) % _BITSET_SIZE);
+			}
+
+			for (size_t bitset_index{ count / _BITSET_SIZE }; bitset_index < bitsets.size(); ++bitset_index) {
+				uint64_t _bitset{ bitsets[bitset_index].to_ullong() };
+
+				if (bitset_index == count / _BITSET_SIZE) {
+					_bitset &= std::numeric_limits<uint64_t>::max() << (count % _BITSET_SIZE);
+				}
+
+				for (; _bitset != 0; _bitset &= _bitset - 1) {
+					erase(bitset_index * _BITSET_SIZE + std::countr_zero(_bitset));
+				}
+			}
+
+			fill(count, thread_count, [&](size_t index) -> decltype(auto) {
+				return generator(index);
+			});
+		}
+
 		void erase(size_t index) {
 			size_t bitset_index{ index / _BITSET_SIZE };
 			size_t bit_index{ index % _BITSET_SIZE };
@@ -195,6 +399,8 @@ namespace Byte {
 
 			bitsets[bitset_index].set(bit_index, false);
 
+			_observer.on_erase(index);
+
 			if (!std::is_trivially_destructible<T>::value)
 			{
 				destroy(&_data[index]);
@@ -232,9 +438,10 @@ namespace Byte {
 		}
 
 		void clear() {
-			if (!std::is_trivially_destructible<T>::value) {
-				for (auto& item : *this) {
-					destroy(&item);
+			if (!std::is_trivially_destructible<T>::value || _OBSERVED) {
+				for (auto it{ first() }; it != end(); ++it) {
+					_observer.on_erase(it.index());
+					destroy(&*it);
 				}
 			}
 
@@ -245,16 +452,21 @@ namespace Byte {
 			bitsets.emplace_back();
 
 			if (_capacity != _BITSET_SIZE) {
+				size_t old_capacity{ _capacity };
+
 				allocator_traits::deallocate(allocator, _data, _capacity);
 				_data = allocator_traits::allocate(allocator, _BITSET_SIZE);
 				_capacity = _BITSET_SIZE;
+
+				notify_shrink(old_capacity, _capacity);
 			}
 
 			_size = 0;
 		}
 
 		iterator begin() {
-			return iterator{ _data, 0 , &bitsets };
+			notify_iterate();
+			return first();
 		}
 
 		iterator end() {
@@ -262,7 +474,8 @@ namespace Byte {
 		}
 
 		const_iterator begin() const {
-			return const_iterator{ _data, 0 , &bitsets };
+			notify_iterate();
+			return first();
 		}
 
 		const_iterator end() const {
@@ -270,7 +483,8 @@ namespace Byte {
 		}
 
 		sparse_vector copy() const {
-			sparse_vector out{ 0 };
+			sparse_vector out{ 0, _observer };
+			out.release();
 
 			out.bitsets = bitsets;
 			out.indices = indices;
@@ -278,11 +492,11 @@ namespace Byte {
 
 			pointer out_data{ allocator_traits::allocate(out.allocator, _capacity) };
 
-			const_iterator _begin{ begin() };
+			const_iterator _begin{ first() };
 			const_iterator _end{ end() };
 
 			for (; _begin != _end; ++_begin) {
-				out_data[_begin.index()] = *_begin;
+				out.construct(out_data + _begin.index(), *_begin);
 			}
 
 			out._data = out_data;
@@ -292,6 +506,18 @@ namespace Byte {
 			return out;
 		}
 
+		void reserve(size_t new_capacity) {
+			if (new_capacity <= _capacity) {
+				return;
+			}
+
+			if (new_capacity % _BITSET_SIZE != 0) {
+				new_capacity += _BITSET_SIZE - (new_capacity % _BITSET_SIZE);
+			}
+
+			expand(std::max(new_capacity, 2 * _capacity));
+		}
+
 		void shrink_to_fit() {
 			if (empty()) {
 				clear();
@@ -323,16 +549,191 @@ namespace Byte {
 			return bitsets[index / 64].test(index % 64);
 		}
 
+		const bitset64& block(size_t bitset_index) const {
+			return bitsets[bitset_index];
+		}
+
+		size_t block_count() const {
+			return bitsets.size();
+		}
+
+		size_t find_next(size_t index) const {
+			for (size_t bitset_index{ index / _BITSET_SIZE }; bitset_index < bitsets.size(); ++bitset_index) {
+				uint64_t _bitset{ bitsets[bitset_index].to_ullong() };
+
+				if (bitset_index == index / _BITSET_SIZE) {
+					_bitset &= std::numeric_limits<uint64_t>::max() << (index % _BITSET_SIZE);
+				}
+
+				if (_bitset != 0) {
+					return bitset_index * _BITSET_SIZE + std::countr_zero(_bitset);
+				}
+			}
+
+			return _capacity;
+		}
+
+		observer_type& observer() {
+			return _observer;
+		}
+
+		const observer_type& observer() const {
+			return _observer;
+		}
+
 	private:
+		iterator first() {
+			return iterator{ _data, 0 , &bitsets };
+		}
+
+		const_iterator first() const {
+			return const_iterator{ _data, 0 , &bitsets };
+		}
+
+		void notify_push(size_t index) {
+			if constexpr (requires(observer_type& observer, size_t value) { observer.on_push(value); }) {
+				_observer.on_push(index);
+			}
+			else {
+				_observer.on_insert(index);
+			}
+		}
+
+		void notify_iterate() const {
+			if constexpr (requires(observer_type& observer) { observer.on_iterate(); }) {
+				_observer.on_iterate();
+			}
+		}
+
+		void notify_shrink(size_t old_capacity, size_t new_capacity) {
+			if constexpr (requires(observer_type& observer, size_t value) { observer.on_shrink(value, value); }) {
+				_observer.on_shrink(old_capacity, new_capacity);
+			}
+		}
+
+		void reset(size_t count) {
+			if constexpr (_OBSERVED) {
+				for (auto it{ first() }; it != end(); ++it) {
+					_observer.on_erase(it.index());
+				}
+			}
+
+			size_t old_capacity{ _capacity };
+			size_t new_capacity{ std::max(count + (_BITSET_SIZE - count % _BITSET_SIZE) % _BITSET_SIZE, _BITSET_SIZE) };
+
+			release();
+
+			_data = allocator_traits::allocate(allocator, new_capacity);
+			_capacity = new_capacity;
+			_size = 0;
+			bitsets.assign(new_capacity / _BITSET_SIZE, bitset64{});
+
+			if (new_capacity > old_capacity) {
+				_observer.on_grow(old_capacity, new_capacity);
+			}
+			else if (new_capacity < old_capacity) {
+				notify_shrink(old_capacity, new_capacity);
+			}
+		}
+
+		template<typename Make>
+		void fill(size_t count, size_t thread_count, Make&& make) {
+			size_t block_count{ (count + _BITSET_SIZE - 1) / _BITSET_SIZE };
+			std::vector<size_t> added(std::max<size_t>(thread_count == 0 ? default_thread_count() : thread_count, 1), 0);
+			bitset_vector previous;
+
+			if constexpr (_OBSERVED) {
+				previous = bitsets;
+			}
+
+			auto finish{ [&] {
+				for (size_t count_added : added) {
+					_size += count_added;
+				}
+
+				indices.clear();
+				for (size_t bitset_index{ 0 }; bitset_index < bitsets.size(); ++bitset_index) {
+					if (!bitsets[bitset_index].all()) {
+						indices.insert(indices.end(), bitset_index);
+					}
+				}
+			} };
+
+			try {
+				parallel_for(block_count, added.size(), [&](size_t thread_index, size_t begin, size_t end) {
+					for (size_t bitset_index{ begin }; bitset_index < end; ++bitset_index) {
+						size_t limit{ std::min(count - bitset_index * _BITSET_SIZE, _BITSET_SIZE) };
+						uint64_t _bitset{ ~bitsets[bitset_index].to_ullong() };
+
+						if (limit != _BITSET_SIZE) {
+							_bitset &= (uint64_t{ 1 } << limit) - 1;
+						}
+
+						uint64_t _constructed{ 0 };
+
+						try {
+							for (; _bitset != 0; _bitset &= _bitset - 1) {
+								size_t index{ bitset_index * _BITSET_SIZE + std::countr_zero(_bitset) };
+
+								allocator_traits::construct(allocator, _data + index, make(index));
+								_constructed |= _bitset & (~_bitset + 1);
+							}
+						}
+						catch (...) {
+							bitsets[bitset_index] |= bitset64{ _constructed };
+							added[thread_index] += std::popcount(_constructed);
+							throw;
+						}
+
+						bitsets[bitset_index] |= bitset64{ _constructed };
+						added[thread_index] += std::popcount(_constructed);
+					}
+				});
+			}
+			catch (...) {
+				finish();
+				throw;
+			}
+
+			finish();
+
+			if constexpr (_OBSERVED) {
+				for (size_t bitset_index{ 0 }; bitset_index < block_count; ++bitset_index) {
+					for (uint64_t _bitset{ bitsets[bitset_index].to_ullong() & ~previous[bitset_index].to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+						notify_push(bitset_index * _BITSET_SIZE + std::countr_zero(_bitset));
+					}
+				}
+			}
+		}
+
+		void release() {
+			if (!_data) {
+				return;
+			}
+
+			if (!std::is_trivially_destructible<T>::value) {
+				for (size_t bitset_index{ 0 }; bitset_index < bitsets.size(); ++bitset_index) {
+					for (uint64_t _bitset{ bitsets[bitset_index].to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+						destroy(_data + bitset_index * _BITSET_SIZE + std::countr_zero(_bitset));
+					}
+				}
+			}
+
+			allocator_traits::deallocate(allocator, _data, _capacity);
+			_data = nullptr;
+		}
+
 		void expand(size_t new_capacity) {
 			pointer temp{ _data };
 
 			_data = allocator_traits::allocate(allocator, new_capacity);
 
-			for (size_t index{ 0 }; index < _size; ++index) {
-				T& item{ temp[index] };
-				construct(_data + index, std::move(item));
-				destroy(temp + index);
+			for (size_t bitset_index{ 0 }; bitset_index < bitsets.size(); ++bitset_index) {
+				for (uint64_t _bitset{ bitsets[bitset_index].to_ullong() }; _bitset != 0; _bitset &= _bitset - 1) {
+					size_t index{ bitset_index * _BITSET_SIZE + std::countr_zero(_bitset) };
+					construct(_data + index, std::move(temp[index]));
+					destroy(temp + index);
+				}
 			}
 
 			allocator_traits::deallocate(allocator, temp, _capacity);
@@ -343,13 +744,17 @@ namespace Byte {
 
 			bitsets.resize(new_capacity / _BITSET_SIZE);
 
+			if (new_capacity > _capacity) {
+				_observer.on_grow(_capacity, new_capacity);
+			}
+
 			_capacity = new_capacity;
 		}
 
 		void shrink(size_t new_capacity) {
 			pointer temp{ _data };
 
-			iterator it{ begin() };
+			iterator it{ first() };
 			iterator _end{ end() };
 
 			_data = allocator_traits::allocate(allocator, new_capacity);
@@ -371,7 +776,11 @@ namespace Byte {
 			}
 
 			bitsets = new_bitsets;
+
+			size_t old_capacity{ _capacity };
 			_capacity = new_capacity;
+
+			notify_shrink(old_capacity, new_capacity);
 		}
 
 		template<class... Args>